@@ -10,6 +10,8 @@
  *						- argument handling for interactive or batch mode
  *						- naming of the output data file
  *						- enable/disable Multithreading
+ *						- parallel processes (fork) with merged output
+ *						- replay of single events with their recorded seeds
  *
  *					The simulation is ready for ..
  * 						- dual and single phase simulations (change LXe -> GXe)
@@ -23,21 +25,31 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
 #include <unistd.h>
+#include <getopt.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 
 // include GEANT4 classes
-//#ifdef G4MULTITHREADED
-//#include "G4MTRunManager.hh"
-//#else
+#ifdef G4MULTITHREADED
+#include "G4MTRunManager.hh"
+#endif
 #include "G4RunManager.hh"
-//#endif
+#include <Randomize.hh>
 #include <G4UImanager.hh>
 #include <G4UIterminal.hh>
 #include <G4UItcsh.hh>
 #include <G4VisExecutive.hh>
 #include <G4UIExecutive.hh>
 
+// include ROOT classes
+#include <TROOT.h>
+#include <TFile.h>
+#include <TTree.h>
+
 //include Muenster TPC simulation classes
 #include "muensterTPCDetectorConstruction.hh"
 #include "muensterTPCPhysicsList.hh"
@@ -49,6 +61,7 @@
 #include "muensterTPCActionInitialization.hh"
 
 void usage();
+bool readreplayseeds (const std::string& hFilename, const std::string& hEventIds, std::vector<int>& hReplayEventIds, std::vector<Long64_t>& hReplaySeeds);
 inline bool fileexists (const std::string& name);
 inline bool fileexists (const char* name);
 
@@ -81,7 +94,11 @@ int main(int argc, char **argv)
 	bool bVerbosities = false;
 	int iVerbosities = 0;
 	int iNbEventsToSimulate = 0;
-	std::string hPreInitFilename, hMacroFilename, hDataFilename;
+	int iNbThreads = 0;
+	int iNbProcesses = 0;
+	bool bReplay = false;
+	int iReplayVerbose = -1;
+	std::string hPreInitFilename, hMacroFilename, hDataFilename, hReplayFilename, hReplayEventIds;
 	std::stringstream hStream;
 	
 	// parse switches
@@ -91,8 +108,17 @@ int main(int argc, char **argv)
 	// n: number of events to simulate
 	// i: interactive session
 	// v: turn on debug verbosities
+	// t: number of worker threads (multi-threaded mode)
+	// j: number of parallel processes (forked after initialization)
+	// replay: simulate events of a datafile again (--replay <file> <eventid>[,<eventid>,..])
+	// replay-verbose: tracking verbosity of the replayed events
+	static struct option hLongOptions[] = {
+		{"replay", required_argument, 0, 'r'},
+		{"replay-verbose", required_argument, 0, 'R'},
+		{0, 0, 0, 0}
+	};
 	if ( argc == 1 ) { bInteractive = true; }
-	while((c = getopt(argc,argv,"p:f:o:n:v:i")) != -1) {
+	while((c = getopt_long(argc,argv,"p:f:o:n:v:t:j:i",hLongOptions,0)) != -1) {
 		switch(c)	{
 			case 'p':
 				bPreInitFromFile = true;
@@ -127,6 +153,37 @@ int main(int argc, char **argv)
 				hStream.clear();
 				hStream >> iVerbosities;
 				break;
+
+			case 't':
+				hStream.str(optarg);
+				hStream.clear();
+				hStream >> iNbThreads;
+				break;
+
+			case 'j':
+				hStream.str(optarg);
+				hStream.clear();
+				hStream >> iNbProcesses;
+				break;
+
+			case 'r':
+				bReplay = true;
+				if (fileexists(optarg))
+					hReplayFilename = optarg;
+				else
+					{ G4cout << "File '" << optarg << "' not found!" << G4endl; usage(); }
+				// the event ids follow the datafile
+				if (optind < argc && argv[optind][0] != '-')
+					hReplayEventIds = argv[optind++];
+				else
+					{ G4cout << "No event id given for '--replay'!" << G4endl; usage(); }
+				break;
+
+			case 'R':
+				hStream.str(optarg);
+				hStream.clear();
+				hStream >> iReplayVerbose;
+				break;
 				
 			case 'i':
 				bInteractive = true;
@@ -167,21 +224,57 @@ int main(int argc, char **argv)
 		}
 	}
 
+	// select the random engine before the run manager is created,
+	// in multi-threaded mode the worker engines are cloned from this one
+	CLHEP::HepRandom::setTheEngine(new CLHEP::RanecuEngine);
+
+	// get the seeds of the events which should be simulated again
+	std::vector<int> hReplayEvents;
+	std::vector<Long64_t> hReplaySeeds;
+	if(bReplay) {
+		if(!readreplayseeds(hReplayFilename, hReplayEventIds, hReplayEvents, hReplaySeeds))
+			usage();
+		// replayed events are simulated one after another in a single thread
+		iNbThreads = 0;
+		iNbProcesses = 0;
+	}
+
+	// parallel processes are only used in batch mode
+	if(iNbProcesses > 1 && (bInteractive || !iNbEventsToSimulate)) {
+		G4cout << "Parallel processes (-j) need a number of events (-n) and no interactive session!" << G4endl;
+		iNbProcesses = 0;
+	}
+	if(iNbProcesses > 1 && iNbThreads > 1) {
+		G4cout << "Parallel processes (-j) can not be combined with worker threads (-t), running sequential processes!" << G4endl;
+		iNbThreads = 0;
+	}
+
 	// create the run manager
-	//#ifdef G4MULTITHREADED
-	//	G4MTRunManager *pRunManager = new G4MTRunManager;
-	//	pRunManager->SetNumberOfThreads(G4Threading::G4GetNumberOfCores());
-	//#else
-		G4RunManager *pRunManager = new G4RunManager;
-	//#endif
+	// the number of threads of a multi-threaded run (-t > 1) can be overwritten by /run/numberOfThreads (preinit.mac)
+	G4RunManager *pRunManager = 0;
+#ifdef G4MULTITHREADED
+	// threads can not be forked, so parallel processes use the sequential run manager,
+	// without -t the run is sequential and writes the output file directly
+	if(iNbThreads > 1 && iNbProcesses <= 1 && !bReplay) {
+		G4MTRunManager *pMTRunManager = new G4MTRunManager;
+		pMTRunManager->SetNumberOfThreads(iNbThreads);
+		// every worker thread writes its own ROOT file
+		ROOT::EnableThreadSafety();
+		pRunManager = pMTRunManager;
+	}
+#else
+	if(iNbThreads > 1)
+		G4cout << "Geant4 was built without multi-threading support, running sequentially!" << G4endl;
+#endif
+	if(!pRunManager)
+		pRunManager = new G4RunManager;
 	
 	// set user-defined initialization classes
 	pRunManager->SetUserInitialization(new muensterTPCDetectorConstruction);
 	pRunManager->SetUserInitialization(new muensterTPCPhysicsList);
 	
-	// create the primary generator action
-	muensterTPCPrimaryGeneratorAction *pPrimaryGeneratorAction = new muensterTPCPrimaryGeneratorAction();
-	pRunManager->SetUserInitialization(new muensterTPCActionInitialization(DatafileName.str(), pPrimaryGeneratorAction));
+	// the primary generator and analysis manager are created for every thread
+	pRunManager->SetUserInitialization(new muensterTPCActionInitialization(DatafileName.str()));
 
 	// start visualization and ui manager
 	G4VisManager* pVisManager = new G4VisExecutive;
@@ -229,7 +322,89 @@ int main(int argc, char **argv)
 		pUImanager->ApplyCommand(hCommand);
 	}
 		
-	if(iNbEventsToSimulate)	{
+	if(bReplay) {
+		// the events start with the recorded seeds and keep their event id
+		for(size_t i=0; i<hReplayEvents.size(); i++) {
+			hStream.str("");
+			hStream.clear();
+			hStream << "/run/replayEvent " << hReplayEvents[i] << " " << hReplaySeeds[2*i] << " " << hReplaySeeds[2*i+1];
+			pUImanager->ApplyCommand(hStream.str());
+		}
+		if(iReplayVerbose >= 0) {
+			hStream.str("");
+			hStream.clear();
+			hStream << "/tracking/verbose " << iReplayVerbose;
+			pUImanager->ApplyCommand(hStream.str());
+		}
+		hStream.str("");
+		hStream.clear();
+		hStream << "/run/beamOn " << hReplayEvents.size();
+		pUImanager->ApplyCommand(hStream.str());
+	}
+	else if(iNbEventsToSimulate && iNbProcesses > 1) {
+		// build the physics tables before forking, the processes share them (copy-on-write)
+		pUImanager->ApplyCommand("/run/beamOn 0");
+
+		// every process gets its own row of the seed table of the RanecuEngine
+		struct timeval hTimeValue;
+		gettimeofday(&hTimeValue, NULL);
+		long lSeedIndex = hTimeValue.tv_usec;
+
+		std::vector<pid_t> hProcessIds;
+		std::vector<G4String> hProcessFilenames;
+		int iFirstEventId = 0;
+		for(int iProcess=0; iProcess<iNbProcesses; iProcess++) {
+			int iNbEventsOfProcess = iNbEventsToSimulate/iNbProcesses + ((iProcess < iNbEventsToSimulate%iNbProcesses)?(1):(0));
+			G4String hProcessFilename = muensterTPCAnalysisManager::GetWorkerDataFilename(DatafileName.str(), iProcess, "_p");
+
+			G4cout.flush();
+			pid_t iProcessId = fork();
+			if(iProcessId == 0) {
+				// child process: simulate a disjoint range of events into its own datafile
+				muensterTPCRunAction *pRunAction = (muensterTPCRunAction *) pRunManager->GetUserRunAction();
+				pRunAction->SetSeedIndex((lSeedIndex+iProcess)%215);
+				pRunAction->GetAnalysisManager()->SetDataFilename(hProcessFilename);
+				pRunAction->GetAnalysisManager()->SetEventIdOffset(iFirstEventId);
+
+				hStream.str("");
+				hStream.clear();
+				hStream << "/run/beamOn " << iNbEventsOfProcess;
+				pUImanager->ApplyCommand(hStream.str());
+
+				delete pRunManager;
+				return 0;
+			}
+			else if(iProcessId < 0) {
+				G4cout << "!!!!> Could not fork process " << iProcess << "!" << G4endl;
+				break;
+			}
+
+			hProcessIds.push_back(iProcessId);
+			hProcessFilenames.push_back(hProcessFilename);
+			iFirstEventId += iNbEventsOfProcess;
+		}
+
+		// wait for all processes and merge their datafiles (nbevents is summed up)
+		bool bProcessesFinished = (int(hProcessIds.size()) == iNbProcesses);
+		for(size_t i=0; i<hProcessIds.size(); i++) {
+			int iStatus = 0;
+			waitpid(hProcessIds[i], &iStatus, 0);
+			if(!WIFEXITED(iStatus) || WEXITSTATUS(iStatus) != 0) {
+				G4cout << "!!!!> Process " << i << " did not finish successfully!" << G4endl;
+				bProcessesFinished = false;
+			}
+		}
+
+		G4cout << "Merging " << hProcessFilenames.size() << " process datafiles into " << DatafileName.str() << G4endl;
+		muensterTPCAnalysisManager *pAnalysisManager = ((muensterTPCRunAction *) pRunManager->GetUserRunAction())->GetAnalysisManager();
+		if(bProcessesFinished && muensterTPCAnalysisManager::MergeDataFiles(hProcessFilenames, DatafileName.str(), pAnalysisManager->GetCompressionSettings())) {
+			for(size_t i=0; i<hProcessFilenames.size(); i++)
+				std::remove(hProcessFilenames[i].c_str());
+		}
+		else
+			G4cout << "!!!!> Merging failed, the process datafiles are kept!" << G4endl;
+	}
+	else if(iNbEventsToSimulate)	{
 		hStream.str("");
 		hStream.clear();
 		hStream << "/run/beamOn " << iNbEventsToSimulate;
@@ -257,6 +432,67 @@ void usage() {
   exit(0);
 }
 
+//******************************************************************/
+// read the recorded seeds of the events to replay (eventid, seed0, seed1)
+//******************************************************************/
+bool readreplayseeds (const std::string& hFilename, const std::string& hEventIds, std::vector<int>& hReplayEventIds, std::vector<Long64_t>& hReplaySeeds) {
+	std::vector<int> hRequestedEventIds;
+	std::stringstream hStream(hEventIds);
+	std::string hEventId;
+	while(std::getline(hStream, hEventId, ','))
+		hRequestedEventIds.push_back(atoi(hEventId.c_str()));
+
+	TFile *pFile = new TFile(hFilename.c_str(), "READ");
+	TTree *pTree = (TTree *) pFile->Get("events/events");
+	if(!pTree || !pTree->GetBranch("seed0") || !pTree->GetBranch("seed1")) {
+		G4cout << "File '" << hFilename << "' contains no recorded seeds!" << G4endl;
+		delete pFile;
+		return false;
+	}
+
+	int iEventId = 0, iPostponed = 0;
+	Long64_t lSeed0 = 0, lSeed1 = 0;
+	pTree->SetBranchStatus("*", 0);
+	pTree->SetBranchStatus("eventid", 1);
+	pTree->SetBranchStatus("seed0", 1);
+	pTree->SetBranchStatus("seed1", 1);
+	pTree->SetBranchAddress("eventid", &iEventId);
+	pTree->SetBranchAddress("seed0", &lSeed0);
+	pTree->SetBranchAddress("seed1", &lSeed1);
+	// events started from a postponed decay track can not be simulated again (older files: unknown)
+	bool bPostponed = (pTree->GetBranch("postponed") != 0);
+	if(bPostponed) {
+		pTree->SetBranchStatus("postponed", 1);
+		pTree->SetBranchAddress("postponed", &iPostponed);
+	}
+	else
+		G4cout << "File '" << hFilename << "' does not record postponed events, events of radioactive decay chains may not be replayed correctly!" << G4endl;
+
+	for(size_t i=0; i<hRequestedEventIds.size(); i++) {
+		bool bFound = false;
+		for(Long64_t iEntry=0; iEntry<pTree->GetEntries() && !bFound; iEntry++) {
+			pTree->GetEntry(iEntry);
+			if(iEventId == hRequestedEventIds[i] && iPostponed) {
+				G4cout << "Event " << iEventId << " started from a postponed decay track of an earlier event and can not be replayed!" << G4endl;
+				bFound = true;
+			}
+			else if(iEventId == hRequestedEventIds[i]) {
+				hReplayEventIds.push_back(iEventId);
+				hReplaySeeds.push_back(lSeed0);
+				hReplaySeeds.push_back(lSeed1);
+				bFound = true;
+			}
+		}
+		if(!bFound)
+			G4cout << "Event " << hRequestedEventIds[i] << " not found in '" << hFilename << "'!" << G4endl;
+	}
+
+	pFile->Close();
+	delete pFile;
+
+	return !hReplayEventIds.empty();
+}
+
 inline bool fileexists (const std::string& name) {
 	return fileexists(name.c_str());
 }
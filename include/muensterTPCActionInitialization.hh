@@ -26,15 +26,14 @@
 class muensterTPCActionInitialization : public G4VUserActionInitialization
 {
   public:
-  	muensterTPCActionInitialization(std::string, muensterTPCPrimaryGeneratorAction*);
+  	muensterTPCActionInitialization(std::string);
     virtual ~muensterTPCActionInitialization();
 
     virtual void BuildForMaster() const;
     virtual void Build() const;
 
   private:
-  	muensterTPCAnalysisManager *pAnalysisManager;
-  	muensterTPCPrimaryGeneratorAction *pPrimaryGeneratorAction;
+  	std::string m_hDatafileName;
 
 };
 
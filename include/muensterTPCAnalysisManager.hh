@@ -14,7 +14,32 @@
 #define __muensterTPCPANALYSISMANAGER_H__
 
 #include <globals.hh>
+#include <G4Timer.hh>
 #include <TParameter.h>
+#include <RVersion.h>
+
+// TBufferMerger: concurrent writing of one output file (ROOT >= 6.10, out of ROOT::Experimental since 6.24)
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+#define MUENSTERTPC_BUFFERMERGER
+#include <ROOT/TBufferMerger.hxx>
+#include <memory>
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,24,0)
+typedef ROOT::TBufferMerger muensterTPCBufferMerger;
+typedef ROOT::TBufferMergerFile muensterTPCBufferMergerFile;
+#else
+typedef ROOT::Experimental::TBufferMerger muensterTPCBufferMerger;
+typedef ROOT::Experimental::TBufferMergerFile muensterTPCBufferMergerFile;
+#endif
+#endif
+
+#include <vector>
+#include <map>
+#include <set>
+#include <ctime>
+
+using std::vector;
+using std::map;
+using std::set;
 
 class G4Run;
 class G4Event;
@@ -25,8 +50,22 @@ class TTree;
 
 class muensterTPCEventData;
 class muensterTPCPrimaryGeneratorAction;
+class muensterTPCAnalysisMessenger;
+class muensterTPCOutputDictionary;
+class muensterTPCOutputWriter;
+class muensterTPCLceMap;
+class muensterTPCPmtDigitizer;
+class muensterTPCEventFilter;
+class muensterTPCFastOptics;
+class muensterTPCLXeSensitiveDetector;
+class muensterTPCPmtSensitiveDetector;
+class muensterTPCSteppingAction;
+class muensterTPCStackingAction;
 
 class muensterTPCAnalysisManager {
+	// the writer thread fills the tree (/Xe/output/asyncWriter)
+	friend class muensterTPCOutputWriter;
+
 public:
 	muensterTPCAnalysisManager(muensterTPCPrimaryGeneratorAction *pPrimaryGeneratorAction);
 	virtual ~muensterTPCAnalysisManager();
@@ -41,16 +80,53 @@ public:
 	void SetDataFilename(const G4String &hFilename) { m_hDataFilename = hFilename; }
 	void SetNbEventsToSimulate(G4int iNbEventsToSimulate) { m_iNbEventsToSimulate = iNbEventsToSimulate; }
 	G4int GetNbEventsToSimulate() { return m_iNbEventsToSimulate; }
+	void SetOutputMode(const G4String &hOutputMode) { m_hOutputMode = hOutputMode; }
+	void SetEventIdOffset(G4int iEventIdOffset) { m_iEventIdOffset = iEventIdOffset; }
+	void SetEncoding(const G4String &hEncoding) { m_hEncoding = hEncoding; }
+	void SetPmtHitsEncoding(const G4String &hPmtHitsEncoding) { m_hPmtHitsEncoding = hPmtHitsEncoding; }
+	muensterTPCLceMap *GetLceMap() { return m_pLceMap; }
+	muensterTPCPmtDigitizer *GetPmtDigitizer() { return m_pPmtDigitizer; }
+	muensterTPCEventFilter *GetEventFilter() { return m_pEventFilter; }
+	// 0 unless the photons are sampled from the lce map in this run
+	muensterTPCFastOptics *GetFastOptics() { return (m_bFastOptics)?(m_pFastOptics):(0); }
+	void SetCompression(const G4String &hAlgorithm, G4int iLevel);
+	G4int GetCompressionSettings() { return m_iCompressionSettings; }
+	void SetBasketSize(const G4String &hBranchName, G4int iBasketSize) { m_hBasketSizes[hBranchName] = iBasketSize; }
+	void SetAutoSave(G4double dAutoSave, const G4String &hAutoSaveUnit);
+	void SetAsyncWriter(G4int iQueueSize) { m_iAsyncQueueSize = iQueueSize; }
+	void SetProfile(const G4String &hProfile);
+	void EnableBranch(const G4String &hBranchName) { m_hEnabledBranches.insert(hBranchName); }
+	void DisableBranch(const G4String &hBranchName) { m_hEnabledBranches.erase(hBranchName); }
+
+	static const vector<G4String> &GetBranchNames();
+
+	static G4String GetWorkerDataFilename(const G4String &hFilename, G4int iWorkerId, const G4String &hWorkerTag = "_t");
+	static G4bool MergeDataFiles(const vector<G4String> &hInputFilenames, const G4String &hOutputFilename, G4int iCompressionSettings = -1);
 
 private:
-	G4bool FilterEvent(muensterTPCEventData *pEventData);
+	G4bool IsMergingMaster();
+	G4bool IsBufferMergerFile();
+	void SelectRunBranches();
+	G4bool IsBranchEnabled(const G4String &hBranchName) { return m_hRunBranches.count(hBranchName) > 0; }
+	G4int GetNbPmts();
+	muensterTPCLXeSensitiveDetector *GetLXeSensitiveDetector();
+	muensterTPCPmtSensitiveDetector *GetPmtSensitiveDetector();
+	muensterTPCSteppingAction *GetSteppingAction();
+	muensterTPCStackingAction *GetStackingAction();
+	void FillTree();
+	void AutoSave();
+	void StopCollectTimer();
+	void PrintOutputStatistics();
+	void MergeWorkerDataFiles();
+	static void WriteDataFileTags();
 
 private:
-	G4int m_iLXeHitsCollectionID;
+	G4int m_iLXeClustersCollectionID;
 	G4int m_iPmtHitsCollectionID;
 
 	G4String m_hDataFilename;
 	G4int m_iNbEventsToSimulate;
+	G4int m_iEventIdOffset;
 
 	TFile *m_pTreeFile;
 	TTree *m_pTree;
@@ -58,9 +134,68 @@ private:
 	
 	TParameter<int> *m_pNbEventsToSimulateParameter;
 
+	// output mode of the worker threads: threadfiles or buffermerger
+	G4String m_hOutputMode;
+#ifdef MUENSTERTPC_BUFFERMERGER
+	static muensterTPCBufferMerger *m_pBufferMerger;
+	std::shared_ptr<muensterTPCBufferMergerFile> m_pBufferMergerFile;
+#endif
+
+	// compression (ROOT settings: 100*algorithm+level, -1 = ROOT default)
+	G4int m_iCompressionSettings;
+	// basket sizes of the branches ("*" = all branches)
+	map<G4String, G4int> m_hBasketSizes;
+	// branches of the events tree (/Xe/output/profile, enableBranch, disableBranch)
+	set<G4String> m_hEnabledBranches;
+	// branches of the current run (steps or clusters)
+	set<G4String> m_hRunBranches;
+	// auto save interval in events, bytes or seconds
+	G4double m_dAutoSave;
+	G4String m_hAutoSaveUnit;
+	G4int m_iNbEventsSinceAutoSave;
+	time_t m_hLastAutoSaveTime;
+	// time spent in writing the tree (see PrintOutputStatistics)
+	G4Timer m_hWriteTimer;
+	G4double m_dWriteTime;
+	// time spent in collecting the event data from the hits collections
+	G4Timer m_hCollectTimer;
+	G4double m_dCollectTime;
+	G4int m_iNbCollectedEvents;
+
+	muensterTPCAnalysisMessenger *m_pAnalysisMessenger;
+
+	// particle and process names: string or code
+	G4String m_hEncoding;
+	G4bool m_bEncodeNames;
+	muensterTPCOutputDictionary *m_pOutputDictionary;
+
+	// pmt hits: dense (pmthits) or sparse (pmtid, pmtcount)
+	G4String m_hPmtHitsEncoding;
+	G4bool m_bSparsePmtHits;
+
+	// light collection efficiency maps instead of tree entries (/Xe/output/lceMap)
+	muensterTPCLceMap *m_pLceMap;
+
+	// waveforms or pulse areas from the pmt hit times (see /Xe/output/digitizer/)
+	muensterTPCPmtDigitizer *m_pPmtDigitizer;
+	G4bool m_bDigitizePmtHits;
+
+	// events failing a filter are not written (see /Xe/output/filter/)
+	muensterTPCEventFilter *m_pEventFilter;
+
+	// scintillation photons sampled from an lce map (see /Xe/optics/fastOptics)
+	muensterTPCFastOptics *m_pFastOptics;
+	G4bool m_bFastOptics;
+
 	muensterTPCPrimaryGeneratorAction *m_pPrimaryGeneratorAction;
 
 	muensterTPCEventData *m_pEventData;
+	// the branches point to this record (the one of the writer thread in async mode)
+	muensterTPCEventData *m_pTreeEventData;
+
+	// writer thread with a queue of this size (0 = fill in EndOfEvent)
+	G4int m_iAsyncQueueSize;
+	muensterTPCOutputWriter *m_pOutputWriter;
 	
 	G4bool writeEmptyEvents;
 };
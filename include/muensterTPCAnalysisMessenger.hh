@@ -0,0 +1,64 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * Communications with the AnalysisManager class (data output)
+ * 
+ * @comment 
+ ******************************************************************/
+#ifndef __MUENSTERTPCANALYSISMESSENGER_H__
+#define __MUENSTERTPCANALYSISMESSENGER_H__
+
+#include <G4UImessenger.hh>
+#include <globals.hh>
+
+class muensterTPCAnalysisManager;
+
+class G4UIcommand;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+
+class muensterTPCAnalysisMessenger: public G4UImessenger
+{
+public:
+  muensterTPCAnalysisMessenger(muensterTPCAnalysisManager *pAnalysisManager);
+  ~muensterTPCAnalysisMessenger();
+  
+  void SetNewValue(G4UIcommand *pCommand, G4String hNewValues);
+
+private:
+  muensterTPCAnalysisManager    *m_pAnalysisManager;
+  G4UIdirectory                 *m_pDirectory;
+  G4UIcmdWithAString            *m_pOutputModeCmd;
+  G4UIcmdWithAString            *m_pEncodingCmd;
+  G4UIcmdWithAString            *m_pPmtHitsCmd;
+  G4UIcommand                   *m_pCompressionCmd;
+  G4UIcommand                   *m_pBasketSizeCmd;
+  G4UIcommand                   *m_pAutoSaveCmd;
+  G4UIcmdWithAnInteger          *m_pAsyncWriterCmd;
+  G4UIcmdWithAString            *m_pProfileCmd;
+  G4UIcmdWithAString            *m_pEnableBranchCmd;
+  G4UIcmdWithAString            *m_pDisableBranchCmd;
+  G4UIcommand                   *m_pLceMapCmd;
+  G4UIcommand                   *m_pLceMapRangeCmd;
+  G4UIdirectory                 *m_pDigitizerDirectory;
+  G4UIcmdWithAString            *m_pDigitizerModeCmd;
+  G4UIcommand                   *m_pDigitizerSamplingCmd;
+  G4UIcommand                   *m_pDigitizerWindowCmd;
+  G4UIcommand                   *m_pDigitizerSpeShapeCmd;
+  G4UIcmdWithAString            *m_pDigitizerSpeTemplateCmd;
+  G4UIcmdWithADouble            *m_pDigitizerGainSpreadCmd;
+  G4UIcmdWithADouble            *m_pDigitizerNoiseCmd;
+  G4UIcommand                   *m_pDigitizerZleCmd;
+  G4UIdirectory                 *m_pFilterDirectory;
+  G4UIcmdWithAString            *m_pFilterPrimaryTypeCmd;
+  G4UIcommand                   *m_pFilterPmtHitsCmd;
+  G4UIcommand                   *m_pFilterEnergyCmd;
+  G4UIcommand                   *m_pFilterFiducialEnergyCmd;
+  G4UIcommand                   *m_pFilterFiducialVolumeCmd;
+  G4UIcommand                   *m_pFilterResetCmd;
+};
+
+#endif 
@@ -25,6 +25,7 @@ class G4LogicalVolume;
 class G4VPhysicalVolume;
 class G4Material;
 class G4UserLimits;
+class G4Region;
 class muensterTPCDetectorMessenger;
 
 #include <G4VUserDetectorConstruction.hh>
@@ -35,6 +36,7 @@ public:
 	~muensterTPCDetectorConstruction();
 
 	G4VPhysicalVolume* Construct();
+	void ConstructSDandField();
 
 	void SetTeflonReflectivity(G4double dReflectivity);
 	void SetGXeTeflonReflectivity(G4double dGXeReflectivity);
@@ -355,6 +357,9 @@ private:
 	G4VPhysicalVolume *m_pTeflonBottomReflectorBottomPhysicalVolume;
 	
 	static map<G4String, G4double> m_hGeometryParameters;
+
+	// LXe/GXe with the optical ray tracer, 0 without (see /Xe/optics/rayTracer)
+	G4Region *m_pOpticsRegion;
 	
 	muensterTPCDetectorMessenger *m_pDetectorMessenger;
 };
@@ -44,6 +44,22 @@ private:
 	G4UIcmdWithADouble *m_pGridMeshTransparencyCmd;
 	G4UIcmdWithADouble *m_pLXeMeshTransparencyCmd;
 	G4UIcmdWithADouble *m_pGXeMeshTransparencyCmd;
+	G4UIcmdWithADoubleAndUnit *m_pLXeEnergyThresholdCmd;
+	G4UIcmdWithAString *m_pLXeParticlesCmd;
+	G4UIcommand *m_pLXeClusteringCmd;
+	G4UIcmdWithAString *m_pPmtHitsCmd;
+	G4UIcommand *m_pPmtTimeHistogramsCmd;
+	G4UIcmdWithAString *m_pKillVolumesCmd;
+	G4UIcmdWithADoubleAndUnit *m_pKillEnergyCmd;
+	G4UIcmdWithABool *m_pAbortOnPrimaryExitCmd;
+
+	G4UIdirectory *m_pOpticsDir;
+	G4UIcmdWithAString *m_pFastOpticsCmd;
+	G4UIcommand *m_pRayTracerCmd;
+	G4UIcmdWithAString *m_pPmtEfficiencyCmd;
+	G4UIcommand *m_pPhotonMaxTrackLengthCmd;
+	G4UIcommand *m_pPhotonMaxTimeCmd;
+	G4UIcommand *m_pPhotonMaxBoundariesCmd;
 
 };
 #endif
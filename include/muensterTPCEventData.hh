@@ -26,14 +26,32 @@ public:
 
 public:
 	void Clear();
+	void Swap(muensterTPCEventData &hEventData);
+
+	// append to a string branch, the strings of cleared events are reused
+	void PushBack(vector<string> *pStrings, const string &hString);
+
+private:
+	void ReleaseStrings(vector<string> *pStrings);
 
 public:
 	int m_iEventId;								// the event ID
+	long long m_lSeed0;						// random seeds at the start of the event (replay)
+	long long m_lSeed1;
+	int m_iPostponed;							// 1: primary from a postponed decay track, no replay
 	int m_iNbTopPmtHits;					// number of top pmt hits
 	int m_iNbBottomPmtHits;				// number of bottom pmt hits
 	int m_iNbTopVetoPmtHits;			// number of top veto pmt hits
 	int m_iNbBottomVetoPmtHits;		// number of bottom veto pmt hits
 	vector<int> *m_pPmtHits;			// number of photon hits per pmt
+	vector<int> *m_pPmtId;				// pmts with hits and their number of hits (/Xe/output/pmtHits sparse)
+	vector<int> *m_pPmtCount;
+	vector<float> *m_pPmtTiming;	// per pmt (pmthits or pmtid order): first photon time, arrival time histogram
+	vector<float> *m_pPmtArea;		// digitized pulse area per pmt (pmthits or pmtid order)
+	vector<int> *m_pWaveformPmt;	// zero suppressed waveforms: pmt, first sample and number of samples of each segment
+	vector<int> *m_pWaveformStart;
+	vector<int> *m_pWaveformLength;
+	vector<float> *m_pWaveformData;	// samples of all segments
 	float m_fTotalEnergyDeposited;// total energy deposited in the ScintSD
 	int m_iNbSteps;								// number of energy depositing steps
 	vector<int> *m_pTrackId;			// id of the particle
@@ -42,17 +60,36 @@ public:
 	vector<string> *m_pParentType;				// type of particle
 	vector<string> *m_pCreatorProcess;		// interaction
 	vector<string> *m_pDepositingProcess;	// energy depositing process
+	vector<int> *m_pParticleTypeCode;			// codes of the names above (/Xe/output/encoding code)
+	vector<int> *m_pParentTypeCode;
+	vector<int> *m_pCreatorProcessCode;
+	vector<int> *m_pDepositingProcessCode;
 	vector<float> *m_pX;					// position of the step
 	vector<float> *m_pY;
 	vector<float> *m_pZ;
 	vector<float> *m_pEnergyDeposited; 			// energy deposited in the step
 	vector<float> *m_pKineticEnergy;	// particle kinetic energy after the step			
 	vector<float> *m_pTime;						// time of the step
+	int m_iNbClusters;						// number of clusters (/Xe/detector/setLXeClustering)
+	vector<int> *m_pClusterTrackId;		// track id of the first step of the cluster
+	vector<string> *m_pClusterType;		// type of this particle
+	vector<int> *m_pClusterTypeCode;
+	vector<float> *m_pClusterX;				// energy weighted position of the cluster
+	vector<float> *m_pClusterY;
+	vector<float> *m_pClusterZ;
+	vector<float> *m_pClusterEnergyDeposited;	// energy deposited in the cluster
+	vector<float> *m_pClusterTime;		// energy weighted time of the cluster
+	vector<int> *m_pClusterNbSteps;		// number of merged steps
 	vector<string> *m_pPrimaryParticleType;		// type of particle
+	vector<int> *m_pPrimaryParticleTypeCode;
 	float m_fPrimaryEnergy;						// energy of the primary particle
 	float m_fPrimaryX;								// position of the primary particle
 	float m_fPrimaryY;
 	float m_fPrimaryZ;	
+
+private:
+	// strings of the cleared events, they keep their memory
+	vector<string> m_hStringPool;
 };
 
 #endif // __muensterTPCPEVENTDATA_H__
@@ -0,0 +1,79 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Chain of event filters evaluated at the end of the event
+ *					before the event data is gathered (see /Xe/output/filter/).
+ *					The cheapest filters come first, the acceptance of each
+ *					filter is printed at the end of the run.
+ ******************************************************************/
+#ifndef __muensterTPCEVENTFILTER_H__
+#define __muensterTPCEVENTFILTER_H__
+
+#include <globals.hh>
+
+#include <set>
+
+#include "muensterTPCLXeCluster.hh"
+
+class muensterTPCLXeHitStore;
+class muensterTPCPmtSensitiveDetector;
+
+using std::set;
+
+class muensterTPCEventFilter {
+public:
+	muensterTPCEventFilter();
+	~muensterTPCEventFilter();
+
+public:
+	void SetPrimaryTypes(const G4String &hPrimaryTypes);
+	void SetMinPmtHits(G4int iMinTopPmtHits, G4int iMinBottomPmtHits);
+	void SetEnergyRange(G4double dMinEnergy, G4double dMaxEnergy);
+	void SetFiducialEnergyRange(G4double dMinEnergy, G4double dMaxEnergy);
+	void SetFiducialVolume(G4double dMaxRadius, G4double dMinZ, G4double dMaxZ);
+	void Reset();
+
+	G4bool IsEnabled();
+
+	void Initialize(G4int iNbTopPmts, G4int iNbBottomPmts);
+	G4bool Accept(const G4String &hPrimaryType, muensterTPCLXeHitStore *pLXeHitStore,
+		muensterTPCLXeClustersCollection *pLXeClustersCollection, muensterTPCPmtSensitiveDetector *pPmtSD);
+
+	void PrintStatistics();
+
+private:
+	G4bool Count(G4int iFilter, G4bool bPassed);
+
+private:
+	// in the order of evaluation
+	enum { PRIMARY_TYPE, PMT_HITS, ENERGY, FIDUCIAL_ENERGY, NB_FILTERS };
+
+	G4bool m_bEnabled[NB_FILTERS];
+
+	// primary particle names
+	set<G4String> m_hPrimaryTypes;
+	// minimum number of photons on the top and bottom pmts
+	G4int m_iMinTopPmtHits;
+	G4int m_iMinBottomPmtHits;
+	G4int m_iNbTopPmts;
+	G4int m_iNbBottomPmts;
+	// total energy deposit
+	G4double m_dMinEnergy;
+	G4double m_dMaxEnergy;
+	// energy deposit in the fiducial volume (default: the drift region)
+	G4double m_dMinFiducialEnergy;
+	G4double m_dMaxFiducialEnergy;
+	G4bool m_bFiducialVolumeSet;
+	G4double m_dFiducialMaxRadius;
+	G4double m_dFiducialMinZ;
+	G4double m_dFiducialMaxZ;
+
+	// events tested and accepted by each filter in this run
+	G4long m_lNbTested[NB_FILTERS];
+	G4long m_lNbPassed[NB_FILTERS];
+};
+
+#endif // __muensterTPCEVENTFILTER_H__
+
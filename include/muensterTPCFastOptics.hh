@@ -0,0 +1,65 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Fast optical simulation with the light collection
+ *					efficiency maps of /Xe/output/lceMap (see /Xe/optics/fastOptics).
+ *					Scintillation photons emitted inside the map are killed at
+ *					birth (stacking action), the detected photons per pmt are
+ *					sampled from the maps at the end of the event (multinomial
+ *					per emission bin) and added to the pmt sensitive detector.
+ ******************************************************************/
+#ifndef __muensterTPCFASTOPTICS_H__
+#define __muensterTPCFASTOPTICS_H__
+
+#include <globals.hh>
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+class muensterTPCPmtSensitiveDetector;
+
+using std::vector;
+
+class muensterTPCFastOptics {
+public:
+	muensterTPCFastOptics();
+	~muensterTPCFastOptics();
+
+public:
+	// shared by all threads, set by the master (/Xe/optics/fastOptics)
+	static G4bool LoadMap(const G4String &hFileName);
+	static void Disable();
+	static G4bool IsEnabled() { return m_iNbPmts > 0; }
+
+	void Initialize();
+	// false: outside of the map, the photon has to be tracked
+	G4bool AddPhoton(const G4ThreeVector &hPosition);
+	void EndOfEvent(muensterTPCPmtSensitiveDetector *pPmtSD);
+
+	void PrintStatistics();
+
+private:
+	static G4int FindBin(const G4ThreeVector &hPosition);
+
+private:
+	// map: rphiz (mm, deg, mm) or xyz (mm) bins without under- and overflow
+	static G4bool m_bCartesian;
+	static G4int m_iNbBins[3];
+	static G4double m_dMin[3];
+	static G4double m_dMax[3];
+	static G4int m_iNbPmts;
+	// m_iNbPmts detection probabilities per bin
+	static vector<float> m_hLce;
+
+	// photons emitted per bin in the current event, only the touched bins are reset
+	vector<G4int> m_hBinPhotons;
+	vector<G4int> m_hEmissionBins;
+
+	G4long m_lNbKilledPhotons;
+	G4long m_lNbDetectedPhotons;
+};
+
+#endif // __muensterTPCFASTOPTICS_H__
+
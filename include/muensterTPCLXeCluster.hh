@@ -0,0 +1,72 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Energy deposits of one track family which are close in
+ *					space and time (see /Xe/detector/setLXeClustering)
+ ******************************************************************/
+#ifndef __muensterTPCPLXECLUSTER_H__
+#define __muensterTPCPLXECLUSTER_H__
+
+#include <G4VHit.hh>
+#include <G4THitsCollection.hh>
+#include <G4Allocator.hh>
+#include <G4ThreeVector.hh>
+#include <G4ParticleDefinition.hh>
+
+class muensterTPCLXeCluster: public G4VHit {
+public:
+	muensterTPCLXeCluster();
+	~muensterTPCLXeCluster();
+	muensterTPCLXeCluster(const muensterTPCLXeCluster &);
+	const muensterTPCLXeCluster & operator=(const muensterTPCLXeCluster &);
+	G4int operator==(const muensterTPCLXeCluster &) const;
+
+	inline void* operator new(size_t);
+	inline void  operator delete(void*);
+
+	void Print();
+
+public:
+	// energy weighted position and time
+	void AddDeposit(const G4ThreeVector &hPosition, G4double dEnergyDeposited, G4double dTime);
+
+	void SetTrackId(G4int iTrackId) { m_iTrackId = iTrackId; }
+	void SetFamilyId(G4int iFamilyId) { m_iFamilyId = iFamilyId; }
+	void SetParticleDefinition(const G4ParticleDefinition *pParticleDefinition) { m_pParticleDefinition = pParticleDefinition; }
+
+	G4int GetTrackId() { return m_iTrackId; }
+	G4int GetFamilyId() { return m_iFamilyId; }
+	const G4ParticleDefinition *GetParticleDefinition() { return m_pParticleDefinition; }
+	G4ThreeVector GetPosition() { return m_hWeightedPosition/m_dEnergyDeposited; }
+	G4double GetEnergyDeposited() { return m_dEnergyDeposited; }
+	G4double GetTime() { return m_dWeightedTime/m_dEnergyDeposited; }
+	G4int GetNbSteps() { return m_iNbSteps; }
+
+private:
+	G4int m_iTrackId;
+	G4int m_iFamilyId;
+	const G4ParticleDefinition *m_pParticleDefinition;
+	G4ThreeVector m_hWeightedPosition;
+	G4double m_dEnergyDeposited;
+	G4double m_dWeightedTime;
+	G4int m_iNbSteps;
+};
+
+typedef G4THitsCollection<muensterTPCLXeCluster> muensterTPCLXeClustersCollection;
+
+extern G4ThreadLocal G4Allocator<muensterTPCLXeCluster> *muensterTPCLXeClusterAllocator;
+
+inline void* muensterTPCLXeCluster::operator new(size_t) {
+	if(!muensterTPCLXeClusterAllocator)
+		muensterTPCLXeClusterAllocator = new G4Allocator<muensterTPCLXeCluster>;
+
+	return((void *) muensterTPCLXeClusterAllocator->MallocSingle());
+}
+
+inline void muensterTPCLXeCluster::operator delete(void *pmuensterTPCLXeCluster) {
+	muensterTPCLXeClusterAllocator->FreeSingle((muensterTPCLXeCluster*) pmuensterTPCLXeCluster);
+}
+
+#endif // __muensterTPCPLXECLUSTER_H__
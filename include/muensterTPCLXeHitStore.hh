@@ -0,0 +1,74 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Steps in the LXe/GXe stored by the sensitive detector as
+ *					structure of arrays (one contiguous array per quantity,
+ *					Geant4 units), the arrays keep their memory across events
+ ******************************************************************/
+#ifndef __muensterTPCPLXEHITSTORE_H__
+#define __muensterTPCPLXEHITSTORE_H__
+
+#include <globals.hh>
+#include <G4ThreeVector.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4VProcess.hh>
+
+#include <vector>
+
+using std::vector;
+
+class muensterTPCLXeHitStore {
+public:
+	muensterTPCLXeHitStore();
+	~muensterTPCLXeHitStore();
+
+public:
+	void Clear();
+	void AddHit(G4int iTrackId, G4int iParentId, const G4ParticleDefinition *pParticleDefinition, const G4ParticleDefinition *pParentDefinition,
+		const G4VProcess *pCreatorProcess, const G4VProcess *pDepositingProcess, const G4ThreeVector &hPosition,
+		G4double dEnergyDeposited, G4double dKineticEnergy, G4double dTime);
+
+	G4int GetNbHits() { return m_hTrackId.size(); }
+	const vector<G4int> &GetTrackIds() { return m_hTrackId; }
+	const vector<G4int> &GetParentIds() { return m_hParentId; }
+	// 0: no parent (primary or the parent did not reach the sensitive volume), no creator process (primary)
+	const vector<const G4ParticleDefinition *> &GetParticleDefinitions() { return m_hParticleDefinition; }
+	const vector<const G4ParticleDefinition *> &GetParentDefinitions() { return m_hParentDefinition; }
+	const vector<const G4VProcess *> &GetCreatorProcesses() { return m_hCreatorProcess; }
+	const vector<const G4VProcess *> &GetDepositingProcesses() { return m_hDepositingProcess; }
+	const vector<float> &GetX() { return m_hX; }
+	const vector<float> &GetY() { return m_hY; }
+	const vector<float> &GetZ() { return m_hZ; }
+	const vector<float> &GetEnergiesDeposited() { return m_hEnergyDeposited; }
+	const vector<float> &GetKineticEnergies() { return m_hKineticEnergy; }
+	const vector<float> &GetTimes() { return m_hTime; }
+
+	// names written for missing parents and creator processes
+	static const G4String &GetParticleName(const G4ParticleDefinition *pParticleDefinition);
+	static const G4String &GetProcessName(const G4VProcess *pProcess);
+
+	// append hValues/dUnit to pOutput in one pass
+	static void AppendInUnit(const vector<float> &hValues, G4double dUnit, vector<float> *pOutput);
+
+private:
+	vector<G4int> m_hTrackId;
+	vector<G4int> m_hParentId;
+	vector<const G4ParticleDefinition *> m_hParticleDefinition;
+	vector<const G4ParticleDefinition *> m_hParentDefinition;
+	vector<const G4VProcess *> m_hCreatorProcess;
+	vector<const G4VProcess *> m_hDepositingProcess;
+	vector<float> m_hX;
+	vector<float> m_hY;
+	vector<float> m_hZ;
+	vector<float> m_hEnergyDeposited;
+	vector<float> m_hKineticEnergy;
+	vector<float> m_hTime;
+
+	static const G4String m_hNoParentType;
+	static const G4String m_hNoProcess;
+};
+
+#endif // __muensterTPCPLXEHITSTORE_H__
+
@@ -15,11 +15,21 @@
 
 #include <G4VSensitiveDetector.hh>
 
-#include "muensterTPCLXeHit.hh"
+#include <map>
+#include <set>
+#include <vector>
+#include <unordered_map>
+
+#include "muensterTPCLXeHitStore.hh"
+#include "muensterTPCLXeCluster.hh"
 
 using std::map;
+using std::set;
+using std::vector;
+using std::unordered_map;
 
 class G4Step;
+class G4Track;
 class G4HCofThisEvent;
 
 class muensterTPCLXeSensitiveDetector: public G4VSensitiveDetector {
@@ -31,10 +41,72 @@ public:
 	G4bool ProcessHits(G4Step *pStep, G4TouchableHistory *pHistory);
 	void EndOfEvent(G4HCofThisEvent *pHitsCollectionOfThisEvent);
 
+	void ResetStatistics();
+	void PrintStatistics();
+
+	// steps of the current event (empty with clustering)
+	muensterTPCLXeHitStore *GetHitStore() { return &m_hHitStore; }
+	// energy stored so far in the current event (steps or clusters)
+	G4bool HasDeposits() { return m_hHitStore.GetNbHits() > 0 || (m_pLXeClustersCollection && m_pLXeClustersCollection->entries() > 0); }
+	// secondaries created in the LXe/GXe in the current event, their energy may not be stored yet
+	G4bool HasSecondaries() { return m_bHasSecondaries; }
+
+	// shared by all threads, set by the master (/Xe/detector/)
+	static void SetEnergyThreshold(G4double dEnergyThreshold) { m_dEnergyThreshold = dEnergyThreshold; }
+	static void SetParticles(const G4String &hParticleNames);
+	// 0 = off, otherwise deposits within this distance and time are merged into clusters
+	static void SetClustering(G4double dClusterDistance, G4double dClusterTime) { m_dClusterDistance = dClusterDistance; m_dClusterTime = dClusterTime; }
+	static G4bool IsClustering() { return m_dClusterDistance > 0.; }
+
 private:
-	muensterTPCLXeHitsCollection* m_pLXeHitsCollection;
+	// particle, creator process and family of a track seen in this event
+	struct TrackInfo {
+		G4int iGeneration;
+		const G4ParticleDefinition *pParticleDefinition;
+		const G4VProcess *pCreatorProcess;
+		G4int iFamilyId;
+	};
+
+	TrackInfo *FindTrack(G4int iTrackId)
+		{ return (iTrackId > 0 && iTrackId < (G4int) m_hTracks.size() && m_hTracks[iTrackId].iGeneration == m_iGeneration)?(&m_hTracks[iTrackId]):(0); }
+	TrackInfo *AddTrack(const G4Track *pTrack);
+
+	G4bool IsParticleAccepted(const G4ParticleDefinition *pParticleDefinition);
+	void AddToCluster(G4int iTrackId, G4int iFamilyId, const G4ParticleDefinition *pParticleDefinition,
+		const G4ThreeVector &hPosition, G4double dEnergyDeposited, G4double dTime);
+	G4long GetClusterCell(const G4ThreeVector &hPosition, G4int iOffsetX = 0, G4int iOffsetY = 0, G4int iOffsetZ = 0);
+
+private:
+	muensterTPCLXeHitStore m_hHitStore;
+	muensterTPCLXeClustersCollection* m_pLXeClustersCollection;
+	G4bool m_bHasSecondaries;
+	G4int m_iClustersCollectionID;
+
+	// tracks indexed by the track id, the entries of older events have an older generation
+	// (parent type of the secondaries, track family)
+	vector<TrackInfo> m_hTracks;
+	G4int m_iGeneration;
+
+	// steps with an energy deposit above the threshold (0 = no zero-deposit steps)
+	static G4double m_dEnergyThreshold;
+	// particles which are stored (empty = all but optical photons)
+	static set<G4String> m_hParticleNames;
+	// whitelist resolved per particle definition in this thread
+	map<const G4ParticleDefinition *, G4bool> m_hAcceptedParticles;
+	set<G4String> m_hAcceptedParticleNames;
+
+	// stored and skipped steps in this run
+	G4long m_lNbStoredSteps;
+	G4long m_lNbSkippedOpticalPhotonSteps;
+	G4long m_lNbSkippedEnergySteps;
+	G4long m_lNbSkippedParticleSteps;
 
-	map<int,G4String> m_hParticleTypes;
+	// clustering (shared settings)
+	static G4double m_dClusterDistance;
+	static G4double m_dClusterTime;
+	// spatial hash: cell of the cluster position (cell size = distance) -> clusters
+	unordered_map<G4long, vector<G4int> > m_hClusterCells;
+	G4long m_lNbClusters;
 };
 
 #endif // __muensterTPCPLXESENSITIVEDETECTOR_H__
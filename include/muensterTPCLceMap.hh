@@ -0,0 +1,61 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Light collection efficiency (LCE) maps, accumulated in
+ *					memory during the run (see /Xe/output/lceMap).
+ *					lce/emitted:			emitted photons per bin (emission position)
+ *					lce/detected_<pmt>:	detected photons per bin and pmt
+ *					lce/lce_<pmt>, lce/lce_top, lce/lce_bottom, lce/lce_total:
+ *														detected/emitted with binomial uncertainties
+ ******************************************************************/
+#ifndef __muensterTPCLCEMAP_H__
+#define __muensterTPCLCEMAP_H__
+
+#include <globals.hh>
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+class TH3D;
+class TDirectory;
+
+using std::vector;
+
+class muensterTPCLceMap {
+public:
+	muensterTPCLceMap();
+	~muensterTPCLceMap();
+
+public:
+	void SetCoordinates(const G4String &hCoordinates) { m_hCoordinates = hCoordinates; }
+	void SetBins(G4int iNbBins1, G4int iNbBins2, G4int iNbBins3);
+	void SetRange(G4double dMin1, G4double dMax1, G4double dMin2, G4double dMax2, G4double dMin3, G4double dMax3);
+	G4bool IsEnabled() { return m_hCoordinates != "off"; }
+
+	void Initialize(G4int iNbTopPmts, G4int iNbBottomPmts, G4int iNbPmts);
+	void Fill(const G4ThreeVector &hPosition, G4int iNbEmitted, const vector<G4int> &hHitPmts, const vector<G4int> &hPmtCounts);
+
+	void Write(TDirectory *pDirectory);
+	static void UpdateMaps(TDirectory *pDirectory);
+
+private:
+	void Reset();
+
+private:
+	// off, rphiz (mm, deg, mm) or xyz (mm)
+	G4String m_hCoordinates;
+	G4int m_iNbBins[3];
+	G4double m_dMin[3];
+	G4double m_dMax[3];
+
+	G4int m_iNbTopPmts;
+	G4int m_iNbBottomPmts;
+
+	TH3D *m_pEmitted;
+	vector<TH3D *> m_hDetected;
+};
+
+#endif // __muensterTPCLCEMAP_H__
+
@@ -0,0 +1,156 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Analytic optical ray tracer for the inside of the PTFE
+ *					cylinder (see /Xe/optics/rayTracer). Fast simulation model
+ *					of the LXe/GXe region: optical photons inside the cylinder
+ *					are killed and traced in batches through an analytic model
+ *					built from the placed volumes at the beginning of the run
+ *					(PTFE wall, liquid surface, grid meshes, pmt arrays).
+ *					The distances to the next surface are computed for the
+ *					whole batch in loops without dependencies (vectorized by
+ *					the compiler), the interactions one photon after the other.
+ ******************************************************************/
+#ifndef __muensterTPCOPTICALRAYTRACER_H__
+#define __muensterTPCOPTICALRAYTRACER_H__
+
+#include <G4VFastSimulationModel.hh>
+#include <G4ThreeVector.hh>
+#include <G4RotationMatrix.hh>
+#include <G4MaterialPropertyVector.hh>
+#include <globals.hh>
+
+#include <vector>
+
+class G4Region;
+class G4VPhysicalVolume;
+class muensterTPCPmtSensitiveDetector;
+
+using std::vector;
+
+class muensterTPCOpticalRayTracer: public G4VFastSimulationModel {
+public:
+	muensterTPCOpticalRayTracer(const G4String &hName, G4Region *pRegion);
+	~muensterTPCOpticalRayTracer();
+
+public:
+	// shared by all threads, set by the master before the initialization (/Xe/optics/rayTracer)
+	static void SetEnabled(G4bool bEnabled) { m_bEnabled = bEnabled; }
+	static G4bool IsEnabled() { return m_bEnabled; }
+	static void SetBatchSize(G4int iBatchSize) { m_iBatchSize = (iBatchSize > 0)?(iBatchSize):(1); }
+	// model of this thread, 0 without ray tracer
+	static muensterTPCOpticalRayTracer *GetInstance() { return m_pInstance; }
+
+	G4bool IsApplicable(const G4ParticleDefinition &hParticleDefinition);
+	G4bool ModelTrigger(const G4FastTrack &hFastTrack);
+	void DoIt(const G4FastTrack &hFastTrack, G4FastStep &hFastStep);
+
+	// analytic model from the geometry and the optical properties of this run
+	void Initialize();
+	// traces the photons left in the batch
+	void EndOfEvent();
+
+	void PrintStatistics();
+
+private:
+	enum PlaneType { PLANE_BOTTOM, PLANE_TOP, PLANE_MESH, PLANE_LIQUID };
+	enum Interaction { BULK, WALL, PLANE };
+	enum Fate { ALIVE, DETECTED, ABSORBED };
+
+	struct SurfaceModel {
+		G4MaterialPropertyVector *pReflectivity;
+		G4MaterialPropertyVector *pSpecularLobe;
+		G4MaterialPropertyVector *pSpecularSpike;
+		G4MaterialPropertyVector *pBackscatter;
+		G4double dSigmaAlpha;
+	};
+
+	struct Placement {
+		G4VPhysicalVolume *pVolume;
+		G4VPhysicalVolume *pMother;
+		G4ThreeVector hPosition;
+	};
+
+	struct MediumModel {
+		G4MaterialPropertyVector *pRefractiveIndex;
+		G4MaterialPropertyVector *pAbsorptionLength;
+		G4MaterialPropertyVector *pRayleighLength;
+	};
+
+	static void FindPlacements(G4VPhysicalVolume *pMother, const G4ThreeVector &hPosition, const G4RotationMatrix &hRotation, vector<Placement> &hPlacements);
+	G4bool BuildModel();
+	void TraceBatch();
+	void ComputeSteps(G4int iNbPhotons);
+	Fate Interact(G4int iPhoton);
+	Fate ReflectOnTeflon(const SurfaceModel &hSurface, G4double dEnergy, const G4ThreeVector &hNormal, G4ThreeVector &hDirection);
+	Fate CrossLiquidSurface(G4int iPhoton, G4ThreeVector &hDirection);
+	Fate HitPmtArray(G4int iPhoton, G4bool bTop, G4ThreeVector &hDirection);
+	void CopyPhoton(G4int iFrom, G4int iTo);
+
+	static G4double GetValue(G4MaterialPropertyVector *pProperty, G4double dEnergy, G4double dDefault);
+	static G4double GetGroupIndex(G4MaterialPropertyVector *pRefractiveIndex, G4double dEnergy);
+	static G4double FresnelReflectance(G4double dIndex1, G4double dIndex2, G4double dCosIncidence);
+	static G4ThreeVector LambertianDirection(const G4ThreeVector &hNormal);
+
+private:
+	static G4bool m_bEnabled;
+	static G4int m_iBatchSize;
+	static G4ThreadLocal muensterTPCOpticalRayTracer *m_pInstance;
+
+	G4bool m_bModelValid;
+	muensterTPCPmtSensitiveDetector *m_pPmtSD;
+
+	// cylinder r < m_dRadius between the pmt arrays, liquid below m_dLiquidZ
+	G4double m_dRadius;
+	G4double m_dBottomZ;
+	G4double m_dTopZ;
+	G4double m_dLiquidZ;
+
+	// all horizontal surfaces, the meshes with their material and thickness
+	vector<G4double> m_hPlaneZ;
+	vector<G4int> m_hPlaneType;
+	vector<G4MaterialPropertyVector *> m_hPlaneAbsorptionLength;
+	vector<G4double> m_hPlaneThickness;
+
+	// pmt windows and photocathodes (centre and half width), pmt number of each window
+	vector<G4double> m_hPmtX;
+	vector<G4double> m_hPmtY;
+	vector<G4int> m_hPmtNb;
+	vector<G4bool> m_hPmtTop;
+	G4double m_dPmtWindowHalfWidth;
+	G4double m_dPmtPhotoCathodeHalfWidth;
+	G4MaterialPropertyVector *m_pWindowRefractiveIndex;
+
+	// 0: LXe, 1: GXe
+	MediumModel m_hMedia[2];
+	SurfaceModel m_hSurfaces[2];
+
+	// photons of the batch as structure of arrays
+	G4int m_iNbPhotons;
+	vector<G4double> m_hX, m_hY, m_hZ;
+	vector<G4double> m_hDx, m_hDy, m_hDz;
+	vector<G4double> m_hTime;
+	vector<G4double> m_hEnergy;
+	// attenuation (1/absorption+1/rayleigh), refractive and group index in LXe and GXe at the photon energy
+	vector<G4double> m_hAttenuation[2];
+	vector<G4double> m_hIndex[2];
+	vector<G4double> m_hGroupIndex[2];
+
+	// next interaction of the batch
+	vector<G4double> m_hRandom;
+	vector<G4double> m_hInvDz;
+	vector<G4double> m_hStep;
+	vector<G4int> m_hInteraction;
+	vector<G4int> m_hPlane;
+
+	G4long m_lNbPhotons;
+	G4long m_lNbDetected;
+	G4long m_lNbBulkAbsorbed;
+	G4long m_lNbSurfaceAbsorbed;
+	G4long m_lNbLost;
+};
+
+#endif // __muensterTPCOPTICALRAYTRACER_H__
+
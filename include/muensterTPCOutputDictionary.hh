@@ -0,0 +1,60 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * 
+ * @comment Integer codes for particle and process names in the
+ *					output file (see /Xe/output/encoding code).
+ *					particles: PDG code, 0 = none, geantino 2000000001,
+ *					chargedgeantino 2000000002, particles without a unique PDG
+ *					code (excited ions without level, generic ions) get a
+ *					hash of their name in [2000000003, 2^31-1)
+ *					processes: index in the sorted process table, 0 = Null
+ ******************************************************************/
+#ifndef __muensterTPCPOUTPUTDICTIONARY_H__
+#define __muensterTPCPOUTPUTDICTIONARY_H__
+
+#include <globals.hh>
+
+#include <map>
+#include <mutex>
+
+using std::map;
+
+class G4ParticleDefinition;
+class G4VProcess;
+
+class muensterTPCOutputDictionary {
+public:
+	muensterTPCOutputDictionary();
+	~muensterTPCOutputDictionary();
+
+public:
+	void Initialize();
+
+	G4int GetParticleCode(const G4String &hParticleName);
+	G4int GetProcessCode(const G4String &hProcessName);
+	// hits: the codes are cached per particle definition and process
+	G4int GetParticleCode(const G4ParticleDefinition *pParticleDefinition);
+	G4int GetProcessCode(const G4VProcess *pProcess);
+
+	void Write();
+
+private:
+	static G4int FindParticleCode(const G4String &hParticleName);
+
+private:
+	// names and codes of all threads, each name has its own code
+	static map<G4String, G4int> m_hSharedParticleCodes;
+	static map<G4int, G4String> m_hSharedParticleNames;
+	static std::mutex m_hParticleCodesMutex;
+
+	// codes used by this thread
+	map<G4String, G4int> m_hParticleCodes;
+	map<G4String, G4int> m_hProcessCodes;
+	map<const G4ParticleDefinition *, G4int> m_hParticleDefinitionCodes;
+	map<const G4VProcess *, G4int> m_hProcessPointerCodes;
+};
+
+#endif // __muensterTPCPOUTPUTDICTIONARY_H__
+
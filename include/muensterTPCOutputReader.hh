@@ -0,0 +1,106 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * 
+ * @comment Helper for the analysis of output files (ROOT only, no Geant4).
+ *					Usage in ROOT:
+ *						.L include/muensterTPCOutputReader.hh
+ *						muensterTPCOutputReader hReader("events.root");
+ *						hReader.GetParticleName(11);  // "e-"
+ *						hReader.GetProcessName(3);
+ *						hReader.ExpandPmtHits(*pmtid, *pmtcount, hPmtHits);  // /Xe/output/pmtHits sparse
+ ******************************************************************/
+#ifndef __muensterTPCPOUTPUTREADER_H__
+#define __muensterTPCPOUTPUTREADER_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TParameter.h>
+
+class muensterTPCOutputReader {
+public:
+	muensterTPCOutputReader(const char *szFilename)
+	{
+		m_iNbPmts = 0;
+
+		TFile *pFile = TFile::Open(szFilename, "READ");
+		if(!pFile)
+			return;
+
+		ReadDictionary((TTree *) pFile->Get("events/typedict"), m_hParticleNames);
+		ReadDictionary((TTree *) pFile->Get("events/procdict"), m_hProcessNames);
+
+		TParameter<int> *pNbPmts = (TParameter<int> *) pFile->Get("events/nbpmts");
+		if(pNbPmts)
+			m_iNbPmts = pNbPmts->GetVal();
+
+		pFile->Close();
+		delete pFile;
+	}
+
+public:
+	// false: the file contains names (/Xe/output/encoding string)
+	bool HasCodes() const { return !m_hParticleNames.empty(); }
+
+	// names of the codes in type, parenttype, type_pri (PDG code, 0 = none, above 2000000000 hashed from the name, see the dictionary of the file)
+	std::string GetParticleName(int iCode) const { return GetName(m_hParticleNames, iCode); }
+	// names of the codes in creaproc, edproc (0 = Null)
+	std::string GetProcessName(int iCode) const { return GetName(m_hProcessNames, iCode); }
+
+	// number of pmts, 0: the file contains pmthits (/Xe/output/pmtHits dense)
+	int GetNbPmts() const { return m_iNbPmts; }
+
+	// pmthits (hits of every pmt) from the pmtid/pmtcount branches
+	void ExpandPmtHits(const std::vector<int> &hPmtId, const std::vector<int> &hPmtCount, std::vector<int> &hPmtHits) const
+	{
+		hPmtHits.assign(m_iNbPmts, 0);
+
+		for(size_t i=0; i<hPmtId.size(); i++)
+		{
+			if(hPmtId[i] >= (int) hPmtHits.size())
+				hPmtHits.resize(hPmtId[i]+1, 0);
+			hPmtHits[hPmtId[i]] = hPmtCount[i];
+		}
+	}
+
+private:
+	static void ReadDictionary(TTree *pTree, std::map<int, std::string> &hNames)
+	{
+		if(!pTree)
+			return;
+
+		int iCode = 0;
+		std::string *pName = 0;
+		pTree->SetBranchAddress("code", &iCode);
+		pTree->SetBranchAddress("name", &pName);
+
+		// merged files contain the dictionary of every thread/process
+		for(Long64_t iEntry=0; iEntry<pTree->GetEntries(); iEntry++)
+		{
+			pTree->GetEntry(iEntry);
+			hNames[iCode] = *pName;
+		}
+
+		pTree->ResetBranchAddresses();
+		delete pName;
+	}
+
+	static std::string GetName(const std::map<int, std::string> &hNames, int iCode)
+	{
+		std::map<int, std::string>::const_iterator pIt = hNames.find(iCode);
+		return (pIt != hNames.end())?(pIt->second):(std::string("unknown"));
+	}
+
+private:
+	std::map<int, std::string> m_hParticleNames;
+	std::map<int, std::string> m_hProcessNames;
+	int m_iNbPmts;
+};
+
+#endif // __muensterTPCPOUTPUTREADER_H__
+
@@ -0,0 +1,66 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * 
+ * @comment Writer thread for the events tree (/Xe/output/asyncWriter).
+ *					Finished events are moved into a bounded queue of recycled
+ *					records, the writer thread fills and compresses them.
+ ******************************************************************/
+#ifndef __muensterTPCPOUTPUTWRITER_H__
+#define __muensterTPCPOUTPUTWRITER_H__
+
+#include <globals.hh>
+
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class muensterTPCAnalysisManager;
+class muensterTPCEventData;
+
+class muensterTPCOutputWriter {
+public:
+	muensterTPCOutputWriter(muensterTPCAnalysisManager *pAnalysisManager, G4int iQueueSize);
+	~muensterTPCOutputWriter();
+
+public:
+	// the branches of the events tree point to this record
+	muensterTPCEventData *GetTreeEventData() { return m_pTreeEventData; }
+
+	void Start();
+	void Push(muensterTPCEventData *pEventData);
+	void Stop();
+
+	void PrintStatistics();
+
+private:
+	void Run();
+
+private:
+	muensterTPCAnalysisManager *m_pAnalysisManager;
+	muensterTPCEventData *m_pTreeEventData;
+
+	// all records, the free ones and the ones waiting for the writer
+	std::vector<muensterTPCEventData *> m_hRecords;
+	std::deque<muensterTPCEventData *> m_hFreeRecords;
+	std::deque<muensterTPCEventData *> m_hQueuedRecords;
+
+	std::thread m_hThread;
+	std::mutex m_hMutex;
+	std::condition_variable m_hRecordFreed;
+	std::condition_variable m_hRecordQueued;
+	G4bool m_bStop;
+
+	// backpressure statistics
+	G4int m_iNbEvents;
+	G4int m_iNbStalls;
+	G4int m_iMaxQueueDepth;
+	G4double m_dSumQueueDepth;
+	G4double m_dStallTime;
+};
+
+#endif // __muensterTPCPOUTPUTWRITER_H__
+
@@ -0,0 +1,88 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Sampled pmt waveforms built from the photon hit times at
+ *					the end of each event (see /Xe/output/digitizer/).
+ *					The waveforms are in units of photoelectrons per sample,
+ *					one single photoelectron pulse has the area 1 (times the
+ *					gain fluctuation).
+ *					area:	pulse area per pmt (pmtarea)
+ *					zle:	zero suppressed waveforms (wfpmt, wfstart, wflength, wfdata)
+ ******************************************************************/
+#ifndef __muensterTPCPMTDIGITIZER_H__
+#define __muensterTPCPMTDIGITIZER_H__
+
+#include <globals.hh>
+
+#include <vector>
+
+#include "muensterTPCPmtHit.hh"
+
+class muensterTPCEventData;
+
+using std::vector;
+
+class muensterTPCPmtDigitizer {
+public:
+	muensterTPCPmtDigitizer();
+	~muensterTPCPmtDigitizer();
+
+public:
+	void SetMode(const G4String &hMode) { m_hMode = hMode; }
+	void SetSamplingPeriod(G4double dSamplingPeriod) { m_dSamplingPeriod = dSamplingPeriod; }
+	void SetWindow(G4double dWindowStart, G4double dWindowLength) { m_dWindowStart = dWindowStart; m_dWindowLength = dWindowLength; }
+	void SetSpeShape(G4double dRiseTime, G4double dFallTime);
+	G4bool SetSpeTemplate(const G4String &hFileName);
+	void SetGainSpread(G4double dGainSpread) { m_dGainSpread = dGainSpread; }
+	void SetNoise(G4double dNoise) { m_dNoise = dNoise; }
+	void SetZeroLengthEncoding(G4double dThreshold, G4int iNbPreSamples, G4int iNbPostSamples);
+
+	const G4String &GetMode() { return m_hMode; }
+	G4bool IsEnabled() { return m_hMode != "off"; }
+	G4double GetSamplingPeriod() { return m_dSamplingPeriod; }
+	G4double GetWindowStart() { return m_dWindowStart; }
+
+	void Initialize(G4int iNbPmts);
+	// pRowPmts: the pmts of the pmtarea rows (pmtid), 0 for all pmts (pmthits)
+	void Digitize(muensterTPCPmtHitsCollection *pPmtHitsCollection, const vector<G4int> *pRowPmts, muensterTPCEventData *pEventData);
+
+private:
+	void AddPulse(float *pWaveform, G4double dTime);
+	void FillZeroLengthEncoding(G4int iPmtNb, const float *pWaveform, muensterTPCEventData *pEventData);
+
+private:
+	// off, area or zle
+	G4String m_hMode;
+	G4double m_dSamplingPeriod;
+	G4double m_dWindowStart;
+	G4double m_dWindowLength;
+
+	// analytic shape (exp(-t/fall)-exp(-t/rise)) unless a template file is given
+	G4double m_dRiseTime;
+	G4double m_dFallTime;
+	vector<G4double> m_hTemplateFileSamples;
+
+	G4double m_dGainSpread;
+	G4double m_dNoise;
+
+	G4double m_dThreshold;
+	G4int m_iNbPreSamples;
+	G4int m_iNbPostSamples;
+
+	// pulse templates for m_iNbPhases sub-sample arrival times, each of m_iTemplateLength samples
+	static const G4int m_iNbPhases = 8;
+	G4int m_iTemplateLength;
+	vector<float> m_hTemplates;
+
+	// one contiguous buffer of m_iNbSamples per pmt, only the rows of hit pmts are reset
+	G4int m_iNbPmts;
+	G4int m_iNbSamples;
+	vector<float> m_hWaveforms;
+	vector<G4int> m_hHitPmts;
+	vector<G4bool> m_hIsHit;
+};
+
+#endif // __muensterTPCPMTDIGITIZER_H__
+
@@ -49,14 +49,17 @@ private:
 
 typedef G4THitsCollection<muensterTPCPmtHit> muensterTPCPmtHitsCollection;
 
-extern G4Allocator<muensterTPCPmtHit> muensterTPCPmtHitAllocator;
+extern G4ThreadLocal G4Allocator<muensterTPCPmtHit> *muensterTPCPmtHitAllocator;
 
 inline void* muensterTPCPmtHit::operator new(size_t) {
-	return((void *) muensterTPCPmtHitAllocator.MallocSingle());
+	if(!muensterTPCPmtHitAllocator)
+		muensterTPCPmtHitAllocator = new G4Allocator<muensterTPCPmtHit>;
+
+	return((void *) muensterTPCPmtHitAllocator->MallocSingle());
 }
 
 inline void muensterTPCPmtHit::operator delete(void *pmuensterTPCPmtHit) {
-	muensterTPCPmtHitAllocator.FreeSingle((muensterTPCPmtHit*) pmuensterTPCPmtHit);
+	muensterTPCPmtHitAllocator->FreeSingle((muensterTPCPmtHit*) pmuensterTPCPmtHit);
 }
 
 #endif // __muensterTPCPPMTHIT_H__
@@ -14,11 +14,17 @@
 #define __muensterTPCPPMTSENSITIVEDETECTOR_H__
 
 #include <G4VSensitiveDetector.hh>
+#include <G4ThreeVector.hh>
+
+#include <vector>
 
 #include "muensterTPCPmtHit.hh"
 
 class G4Step;
 class G4HCofThisEvent;
+class G4ParticleDefinition;
+
+using std::vector;
 
 class muensterTPCPmtSensitiveDetector: public G4VSensitiveDetector {
 public:
@@ -29,8 +35,58 @@ public:
 	G4bool ProcessHits(G4Step *pStep, G4TouchableHistory *pHistory);
 	void EndOfEvent(G4HCofThisEvent *pHitsCollectionOfThisEvent);
 
+	// hits per pmt of the current event, the hit pmts in the order of their first hit
+	const vector<G4int> &GetPmtCounts() { return m_hPmtCounts; }
+	const vector<G4int> &GetHitPmts() { return m_hHitPmts; }
+	G4int GetNbHits() { return m_iNbHits; }
+	// photon traced without Geant4 stepping (see /Xe/optics/rayTracer)
+	G4bool AddPhoton(G4int iPmtNb, G4double dTime, const G4ThreeVector &hPosition);
+	// photons detected without tracking (see /Xe/optics/fastOptics), added at the end of the event
+	void AddCounts(G4int iPmtNb, G4int iNbCounts);
+
+	// arrival time histogram (m_iNbTimeBins counts) and time of the first photon of a hit pmt
+	const G4int *GetTimeHistogram(G4int iPmtNb) { return m_hTimeHistograms.data()+iPmtNb*m_iNbTimeBins; }
+	G4double GetFirstTime(G4int iPmtNb) { return m_hFirstTimes[iPmtNb]; }
+
+	// configuration of all threads, set by the master (see /Xe/detector/setPmtHits)
+	static void SetStoreHits(G4bool bStoreHits) { m_bStoreHits = bStoreHits; }
+	static G4bool IsStoringHits() { return m_bStoreHits; }
+	static void SetTimeHistograms(G4int iNbTimeBins, G4double dTimeMin, G4double dTimeMax);
+	static G4bool IsTimeHistogramming() { return m_iNbTimeBins > 0; }
+	static G4int GetNbTimeBins() { return m_iNbTimeBins; }
+	static G4double GetTimeMin() { return m_dTimeMin; }
+	static G4double GetTimeMax() { return m_dTimeMax; }
+	// detection efficiency (QExCE) per pmt (see /Xe/optics/pmtEfficiency): the maximum is applied
+	// when the photons are created (stacking action), the relative efficiency of the pmt here
+	static void SetEfficiencies(const vector<G4double> &hEfficiencies);
+	static G4bool IsPreSampling() { return m_dMaxEfficiency < 1.; }
+	static G4double GetMaxEfficiency() { return m_dMaxEfficiency; }
+
 private:
 	muensterTPCPmtHitsCollection* m_pPmtHitsCollection;
+	G4int m_iHitsCollectionID;
+
+	const G4ParticleDefinition *m_pOpticalPhotonDefinition;
+
+	// only counts unless the hits (position, time) are needed
+	static G4bool m_bStoreHits;
+
+	vector<G4int> m_hPmtCounts;
+	vector<G4int> m_hHitPmts;
+	G4int m_iNbHits;
+
+	// global time histograms per event, off with 0 bins (see /Xe/detector/setPmtTimeHistograms)
+	static G4int m_iNbTimeBins;
+	static G4double m_dTimeMin;
+	static G4double m_dTimeMax;
+
+	// 1 without efficiencies, pmts without relative efficiency have the maximum
+	static G4double m_dMaxEfficiency;
+	static vector<G4double> m_hRelativeEfficiencies;
+
+	// m_iNbTimeBins bins per pmt in one array, only the rows of hit pmts are reset
+	vector<G4int> m_hTimeHistograms;
+	vector<G4double> m_hFirstTimes;
 };
 
 #endif // __muensterTPCPPMTSENSITIVEDETECTOR_H__
@@ -17,6 +17,8 @@
 #include <G4ThreeVector.hh>
 #include <globals.hh>
 
+#include <deque>
+
 #include <TRandom3.h>
 
 #include "muensterTPCPrimaryGeneratorMessenger.hh"
@@ -40,6 +42,12 @@ public:
 	void     SetWriteEmpty(G4bool doit){writeEmpty = doit;};
 	G4bool   GetWriteEmpty(){return writeEmpty;};
 
+	// replay of single events: the next events start with the recorded seeds
+	void AddReplayEvent(G4int iEventId, long lSeed0, long lSeed1);
+	G4int GetReplayEventId() { return m_iReplayEventId; }
+	// the primary is a postponed track of an earlier event (radioactive decay chain), the seeds do not replay it
+	G4bool IsFromPostponedStack() { return m_bFromPostponedStack; }
+
   private:
 	muensterTPCPrimaryGeneratorMessenger *m_pMessenger;
 	long m_lSeeds[2];
@@ -48,6 +56,11 @@ public:
 	G4double m_dEnergyOfPrimary;
 	G4ThreeVector m_hPositionOfPrimary;
 
+	std::deque<G4int> m_hReplayEventIds;
+	std::deque<long> m_hReplaySeeds;
+	G4int m_iReplayEventId;
+	G4bool m_bFromPostponedStack;
+
 	muensterTPCParticleSource *m_pParticleSource;
 };
 
@@ -30,6 +30,7 @@ private:
   muensterTPCPrimaryGeneratorAction *m_pPrimaryGeneratorAction;
   G4UIdirectory                 *m_pDirectory;
   G4UIcmdWithABool              *m_pWriteEmptyCmd;
+  G4UIcommand                   *m_pReplayEventCmd;
 
 };
 
@@ -14,6 +14,7 @@
 #define __muensterTPCPRUNACTION_H__
 
 #include <G4UserRunAction.hh>
+#include <globals.hh>
 
 class G4Run;
 
@@ -28,8 +29,13 @@ public:
 	void BeginOfRunAction(const G4Run *pRun);
 	void EndOfRunAction(const G4Run *pRun);
 
+	muensterTPCAnalysisManager *GetAnalysisManager() { return m_pAnalysisManager; }
+	// fixed index into the seed table of the RanecuEngine (< 0: seed from the time)
+	void SetSeedIndex(G4long lSeedIndex) { m_lSeedIndex = lSeedIndex; }
+
 private:
 	muensterTPCAnalysisManager *m_pAnalysisManager;
+	G4long m_lSeedIndex;
 };
 
 #endif // __muensterTPCPRUNACTION_H__
@@ -27,8 +27,15 @@ public:
 	virtual void NewStage();
 	virtual void PrepareNewEvent();
 
+	void ResetStatistics();
+	void PrintStatistics();
+
 private:
 	muensterTPCAnalysisManager *m_pAnalysisManager;
+
+	// optical photons seen and killed by the efficiency pre-sampling (see /Xe/optics/pmtEfficiency)
+	G4long m_lNbOpticalPhotons;
+	G4long m_lNbKilledOpticalPhotons;
 };
 
 #endif // __muensterTPCPSTACKINGACTION_H__
@@ -0,0 +1,93 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment Track killing and event abort policies for background
+ *					simulations (see /Xe/detector/setKillVolumes, setKillEnergy
+ *					and setAbortOnPrimaryExit). All policies are off per
+ *					default and neglect what could come back to the LXe.
+ *					Optical photons are only killed by the limits of the
+ *					optical regions (see /Xe/optics/setPhotonMax*):
+ *					LXe:	liquid inside the PTFE cylinder
+ *					GXe:	gas inside the PTFE cylinder
+ *					gaps:	everything outside the PTFE cylinder radius
+ ******************************************************************/
+#ifndef __muensterTPCSTEPPINGACTION_H__
+#define __muensterTPCSTEPPINGACTION_H__
+
+#include <globals.hh>
+#include <G4UserSteppingAction.hh>
+
+#include <vector>
+
+using std::vector;
+
+class G4VPhysicalVolume;
+class G4Material;
+class G4VTouchable;
+class muensterTPCLXeSensitiveDetector;
+
+class muensterTPCSteppingAction: public G4UserSteppingAction {
+public:
+	muensterTPCSteppingAction();
+	~muensterTPCSteppingAction();
+
+	virtual void UserSteppingAction(const G4Step *pStep);
+
+	// volumes and counters of this run
+	void Initialize();
+	void PrintStatistics();
+
+	// shared by all threads, set by the master (/Xe/detector/)
+	static void SetKillVolumes(const G4String &hVolumeNames);
+	static void SetKillEnergy(G4double dKillEnergy) { m_dKillEnergy = dKillEnergy; }
+	static void SetAbortOnPrimaryExit(G4bool bAbortOnPrimaryExit) { m_bAbortOnPrimaryExit = bAbortOnPrimaryExit; }
+	static G4bool IsEnabled() { return !m_hKillVolumeNames.empty() || m_dKillEnergy > 0.; }
+
+	// optical photon limits per region (LXe, GXe, gaps or all), 0: no limit (/Xe/optics/)
+	static void SetPhotonMaxTrackLength(const G4String &hRegion, G4double dMaxTrackLength);
+	static void SetPhotonMaxTime(const G4String &hRegion, G4double dMaxTime);
+	static void SetPhotonMaxBoundaries(const G4String &hRegion, G4int iMaxBoundaries);
+	static G4bool HasPhotonLimits();
+
+private:
+	enum PhotonRegion { REGION_LXE, REGION_GXE, REGION_GAPS, NB_REGIONS };
+	enum PhotonLimit { LIMIT_TRACK_LENGTH, LIMIT_TIME, LIMIT_BOUNDARIES, NB_LIMITS };
+
+	G4bool IsInKillVolumes(const G4VTouchable *pTouchable);
+	void ApplyPhotonLimits(const G4Step *pStep);
+	static G4bool IsRegion(const G4String &hRegion, G4int iRegion);
+
+private:
+	// tracks leaving these volumes (and their daughters) are killed
+	static vector<G4String> m_hKillVolumeNames;
+	// tracks below this kinetic energy outside the LXe sensitive volumes are killed
+	static G4double m_dKillEnergy;
+	// the event is aborted when a primary leaves the kill volumes before it interacted in the LXe/GXe
+	// and no other track is pending on the stack
+	static G4bool m_bAbortOnPrimaryExit;
+
+	static const char *m_szRegionNames[NB_REGIONS];
+	static G4double m_dPhotonMaxTrackLength[NB_REGIONS];
+	static G4double m_dPhotonMaxTime[NB_REGIONS];
+	static G4int m_iPhotonMaxBoundaries[NB_REGIONS];
+
+	vector<G4VPhysicalVolume *> m_hKillVolumes;
+	muensterTPCLXeSensitiveDetector *m_pLXeSD;
+
+	G4long m_lNbKilledLeavingTracks;
+	G4long m_lNbKilledLowEnergyTracks;
+	G4long m_lNbAbortedEvents;
+
+	// the regions of this run, geometry boundaries of the current optical photon
+	G4Material *m_pLXeMaterial;
+	G4Material *m_pGXeMaterial;
+	G4double m_dTpcRadius;
+	G4int m_iNbPhotonBoundaries;
+
+	G4long m_lNbKilledPhotons[NB_REGIONS][NB_LIMITS];
+};
+
+#endif // __muensterTPCSTEPPINGACTION_H__
+
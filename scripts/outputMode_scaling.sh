@@ -0,0 +1,37 @@
+#!/bin/bash
+# --------------------------------------------------------------
+# Compare the multi-threaded output modes of MuensterTPC-MC
+#   threadfiles:  one file per worker thread, merged after the run
+#   buffermerger: in-memory files merged by TBufferMerger during the run
+#
+# usage: ./scripts/outputMode_scaling.sh <source_definition.mac> <number_of_events> [threads ...]
+# e.g.   ./scripts/outputMode_scaling.sh ./macros/src_Cs137.mac 100000 1 2 4 8
+# --------------------------------------------------------------
+MACRO=${1:-./macros/src_Cs137.mac}
+NBEVENTS=${2:-10000}
+# without the optional arguments there is nothing to shift
+shift $(( $# < 2 ? $# : 2 ))
+THREADS=${@:-1 2 4 8}
+
+OUTDIR=$(mktemp -d)
+
+printf "%-13s %8s %10s %14s %12s\n" "mode" "threads" "time [s]" "events/s" "size [MB]"
+for MODE in threadfiles buffermerger; do
+	# the output mode has to be known before the first run
+	PREINIT=${OUTDIR}/preinit_${MODE}.mac
+	echo "/Xe/output/mode ${MODE}" > ${PREINIT}
+	cat ./macros/preinit.mac >> ${PREINIT}
+
+	for NB in ${THREADS}; do
+		START=$(date +%s.%N)
+		./MuensterTPC-MC -p ${PREINIT} -f ${MACRO} -n ${NBEVENTS} -t ${NB} -o ${OUTDIR}/${MODE}_t${NB}.root > ${OUTDIR}/${MODE}_t${NB}.log 2>&1
+		STOP=$(date +%s.%N)
+
+		FILE=$(ls ${OUTDIR}/*_${MODE}_t${NB}.root 2>/dev/null | head -n 1)
+		SIZE=$(du -m ${FILE} 2>/dev/null | cut -f1)
+		TIME=$(echo "${STOP} - ${START}" | bc)
+		printf "%-13s %8d %10.1f %14.1f %12s\n" ${MODE} ${NB} ${TIME} $(echo "${NBEVENTS} / ${TIME}" | bc -l) ${SIZE:-n/a}
+	done
+done
+
+rm -rf ${OUTDIR}
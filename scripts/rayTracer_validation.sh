@@ -0,0 +1,87 @@
+#!/bin/bash
+# --------------------------------------------------------------
+# Validate the optical ray tracer (/Xe/optics/rayTracer) against full
+# Geant4 tracking of the optical photons: the same lce map of the active
+# volume is built with both and the top, bottom and total lce are
+# compared bin by bin
+#
+# usage: ./scripts/rayTracer_validation.sh [number_of_events] [threads] [r bins] [z bins]
+# e.g.   ./scripts/rayTracer_validation.sh 1000000 4 8 17
+# --------------------------------------------------------------
+NBEVENTS=${1:-1000000}
+THREADS=${2:-4}
+RBINS=${3:-8}
+ZBINS=${4:-17}
+
+OUTDIR=$(mktemp -d)
+
+# single photons in the active volume (src_optPhot_DP_S1.mac), no phi dependence
+MACRO=${OUTDIR}/lceMap.mac
+cat ./macros/src_optPhot_DP_S1.mac > ${MACRO}
+echo "" >> ${MACRO}
+echo "/Xe/output/lceMap rphiz ${RBINS} 1 ${ZBINS}" >> ${MACRO}
+
+printf "%-10s %10s\n" "optics" "time [s]"
+for MODE in tracking rayTracer; do
+	# the ray tracer has to be known before the initialization
+	PREINIT=${OUTDIR}/preinit_${MODE}.mac
+	[ ${MODE} == rayTracer ] && echo "/Xe/optics/rayTracer true" > ${PREINIT}
+	cat ./macros/preinit.mac >> ${PREINIT}
+
+	START=$(date +%s.%N)
+	./MuensterTPC-MC -p ${PREINIT} -f ${MACRO} -n ${NBEVENTS} -t ${THREADS} -o ${OUTDIR}/${MODE}.root > ${OUTDIR}/${MODE}.log 2>&1
+	STOP=$(date +%s.%N)
+
+	printf "%-10s %10.1f\n" ${MODE} $(echo "${STOP} - ${START}" | bc)
+done
+
+TRACKING=$(ls ${OUTDIR}/*tracking.root 2>/dev/null | head -n 1)
+RAYTRACER=$(ls ${OUTDIR}/*rayTracer.root 2>/dev/null | head -n 1)
+
+cat > ${OUTDIR}/compare.C <<'EOF'
+void compare(const char *szTracking, const char *szRayTracer)
+{
+	TFile *pTracking = TFile::Open(szTracking);
+	TFile *pRayTracer = TFile::Open(szRayTracer);
+	if(!pTracking || !pRayTracer)
+		return;
+
+	const char *szMaps[] = {"lce_top", "lce_bottom", "lce_total"};
+	printf("%-11s %10s %10s %8s %10s\n", "map", "tracking", "raytracer", "ratio", "chi2/ndf");
+	for(int i=0; i<3; i++)
+	{
+		TH3D *pA = (TH3D *) pTracking->Get(Form("lce/%s", szMaps[i]));
+		TH3D *pB = (TH3D *) pRayTracer->Get(Form("lce/%s", szMaps[i]));
+		if(!pA || !pB)
+		{
+			printf("%-11s missing\n", szMaps[i]);
+			continue;
+		}
+
+		// mean lce of the bins and chi2 with the binomial errors of both maps
+		double dSumA = 0., dSumB = 0., dChi2 = 0.;
+		int iNdf = 0;
+		for(int iBin=0; iBin<pA->GetNcells(); iBin++)
+		{
+			if(pA->IsBinUnderflow(iBin) || pA->IsBinOverflow(iBin))
+				continue;
+
+			double dError2 = pow(pA->GetBinError(iBin), 2)+pow(pB->GetBinError(iBin), 2);
+			if(dError2 <= 0.)
+				continue;
+
+			dSumA += pA->GetBinContent(iBin);
+			dSumB += pB->GetBinContent(iBin);
+			dChi2 += pow(pA->GetBinContent(iBin)-pB->GetBinContent(iBin), 2)/dError2;
+			iNdf++;
+		}
+
+		if(iNdf > 0)
+			printf("%-11s %10.4f %10.4f %8.3f %10.2f\n", szMaps[i], dSumA/iNdf, dSumB/iNdf, (dSumA > 0.)?(dSumB/dSumA):(0.), dChi2/iNdf);
+	}
+}
+EOF
+
+root -l -b -q "${OUTDIR}/compare.C(\"${TRACKING}\", \"${RAYTRACER}\")"
+
+rm -rf ${OUTDIR}
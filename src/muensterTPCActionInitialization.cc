@@ -15,20 +15,19 @@
 #include <unistd.h>
 #include <sys/time.h>
 
+#include <G4Threading.hh>
+
 #include "muensterTPCActionInitialization.hh"
 #include "muensterTPCPrimaryGeneratorAction.hh"
 #include "muensterTPCAnalysisManager.hh"
 #include "muensterTPCStackingAction.hh"
+#include "muensterTPCSteppingAction.hh"
 #include "muensterTPCRunAction.hh"
 #include "muensterTPCEventAction.hh"
 
-muensterTPCActionInitialization::muensterTPCActionInitialization (std::string NewDatafileName, muensterTPCPrimaryGeneratorAction *pNewPrimaryGeneratorAction) {	
-	pPrimaryGeneratorAction = pNewPrimaryGeneratorAction;
-  
-	// create an analysis manager object
-	pAnalysisManager = new muensterTPCAnalysisManager(pPrimaryGeneratorAction);
-	// set the filename for the root datafile
-	pAnalysisManager->SetDataFilename(NewDatafileName);
+muensterTPCActionInitialization::muensterTPCActionInitialization (std::string NewDatafileName) {	
+	// the filename for the root datafile (merged output in multi-threaded mode)
+	m_hDatafileName = NewDatafileName;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -40,14 +39,29 @@ muensterTPCActionInitialization::~muensterTPCActionInitialization() {
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void muensterTPCActionInitialization::BuildForMaster() const {
-  SetUserAction(new muensterTPCRunAction(pAnalysisManager));
+	// the master analysis manager only merges the worker datafiles
+	muensterTPCAnalysisManager *pAnalysisManager = new muensterTPCAnalysisManager(0);
+	pAnalysisManager->SetDataFilename(m_hDatafileName);
+
+	SetUserAction(new muensterTPCRunAction(pAnalysisManager));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void muensterTPCActionInitialization::Build() const {
+	// every (worker) thread gets its own primary generator and analysis manager
+	muensterTPCPrimaryGeneratorAction *pPrimaryGeneratorAction = new muensterTPCPrimaryGeneratorAction();
+	muensterTPCAnalysisManager *pAnalysisManager = new muensterTPCAnalysisManager(pPrimaryGeneratorAction);
+
+	// worker threads write to their own file, which is merged at the end of the run
+	if(G4Threading::IsWorkerThread())
+		pAnalysisManager->SetDataFilename(muensterTPCAnalysisManager::GetWorkerDataFilename(m_hDatafileName, G4Threading::G4GetThreadId()));
+	else
+		pAnalysisManager->SetDataFilename(m_hDatafileName);
+
 	SetUserAction(pPrimaryGeneratorAction);
 	SetUserAction(new muensterTPCStackingAction(pAnalysisManager));
+	SetUserAction(new muensterTPCSteppingAction());
 	SetUserAction(new muensterTPCRunAction(pAnalysisManager));
 	SetUserAction(new muensterTPCEventAction(pAnalysisManager));
 }
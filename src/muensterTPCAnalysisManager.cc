@@ -16,12 +16,22 @@
 #include <G4SDManager.hh>
 #include <G4Run.hh>
 #include <G4Event.hh>
+#include <G4PrimaryVertex.hh>
 #include <G4HCofThisEvent.hh>
 #include <G4SystemOfUnits.hh>
 #include <G4Version.hh>
+#include <G4Threading.hh>
+#include <G4RunManager.hh>
+#ifdef G4MULTITHREADED
+#include <G4MTRunManager.hh>
+#endif
 
 // include C++ classes
 #include <numeric>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
 
 // include ROOT classes
 #include <TROOT.h>
@@ -29,15 +39,33 @@
 #include <TTree.h>
 #include <TParameter.h>
 #include <TDirectory.h>
+#include <TFileMerger.h>
 
 // include Muenster TPC classes
 #include "muensterTPCPrimaryGeneratorAction.hh"
 #include "muensterTPCAnalysisManager.hh"
+#include "muensterTPCAnalysisMessenger.hh"
+#include "muensterTPCOutputDictionary.hh"
+#include "muensterTPCOutputWriter.hh"
+#include "muensterTPCLceMap.hh"
+#include "muensterTPCPmtDigitizer.hh"
+#include "muensterTPCEventFilter.hh"
+#include "muensterTPCFastOptics.hh"
+#include "muensterTPCOpticalRayTracer.hh"
 #include "muensterTPCEventData.hh"
-#include "muensterTPCLXeHit.hh"
-#include "muensterTPCPmtHit.hh"
+#include "muensterTPCLXeHitStore.hh"
+#include "muensterTPCLXeCluster.hh"
+#include "muensterTPCLXeSensitiveDetector.hh"
+#include "muensterTPCPmtSensitiveDetector.hh"
+#include "muensterTPCSteppingAction.hh"
+#include "muensterTPCStackingAction.hh"
 #include "muensterTPCDetectorConstruction.hh"
 
+#ifdef MUENSTERTPC_BUFFERMERGER
+// shared by all threads, created and deleted by the master (buffermerger mode)
+muensterTPCBufferMerger *muensterTPCAnalysisManager::m_pBufferMerger = 0;
+#endif
+
 //******************************************************************/
 // creation and initialization of the AnalysisManager
 //******************************************************************/
@@ -45,7 +73,7 @@ muensterTPCAnalysisManager::muensterTPCAnalysisManager(muensterTPCPrimaryGenerat
   G4int threadID = G4Threading::IsMultithreadedApplication() ? G4Threading::G4GetThreadId() : 0;
 	
 	// initialization of the HitsCollectionID variables 
-	m_iLXeHitsCollectionID = -1;
+	m_iLXeClustersCollectionID = -1;
 	m_iPmtHitsCollectionID = -1;
 
 	// default output file name (which should be redifined in the main class)
@@ -55,7 +83,45 @@ muensterTPCAnalysisManager::muensterTPCAnalysisManager(muensterTPCPrimaryGenerat
 	m_pPrimaryGeneratorAction = pPrimaryGeneratorAction;
 	// declaration of the EventData class
 	m_pEventData = new muensterTPCEventData();
+	m_pTreeEventData = m_pEventData;
 	writeEmptyEvents = kFALSE;
+
+	// per default the tree is filled in EndOfEvent
+	m_iAsyncQueueSize = 0;
+	m_pOutputWriter = 0;
+
+	// first event id of this process (forked processes, see -j)
+	m_iEventIdOffset = 0;
+
+	// per default every worker thread writes its own file
+	m_hOutputMode = "threadfiles";
+
+	// ROOT default compression and basket sizes, auto save every 10000 events
+	m_iCompressionSettings = -1;
+	m_dAutoSave = 10000;
+	m_hAutoSaveUnit = "events";
+	m_iNbEventsSinceAutoSave = 0;
+	m_hLastAutoSaveTime = 0;
+	m_dWriteTime = 0.;
+	m_dCollectTime = 0.;
+	m_iNbCollectedEvents = 0;
+	// per default particle and process names are written as strings
+	m_hEncoding = "string";
+	m_bEncodeNames = false;
+	m_pOutputDictionary = new muensterTPCOutputDictionary();
+	// per default the hits of every pmt are written (pmthits)
+	m_hPmtHitsEncoding = "dense";
+	m_bSparsePmtHits = false;
+	m_pLceMap = new muensterTPCLceMap();
+	m_pPmtDigitizer = new muensterTPCPmtDigitizer();
+	m_bDigitizePmtHits = false;
+	m_pEventFilter = new muensterTPCEventFilter();
+	m_pFastOptics = new muensterTPCFastOptics();
+	m_bFastOptics = false;
+	// per default all branches are written
+	SetProfile("full");
+
+	m_pAnalysisMessenger = new muensterTPCAnalysisMessenger(this);
 }
 
 
@@ -63,24 +129,115 @@ muensterTPCAnalysisManager::muensterTPCAnalysisManager(muensterTPCPrimaryGenerat
 //
 //******************************************************************/
 muensterTPCAnalysisManager::~muensterTPCAnalysisManager(){
+	delete m_pAnalysisMessenger;
+	delete m_pOutputDictionary;
+	delete m_pLceMap;
+	delete m_pPmtDigitizer;
+	delete m_pEventFilter;
+	delete m_pFastOptics;
 }
 
 //******************************************************************/
 // define the BeginOfRun actions / prepare the output file for data output
 //******************************************************************/
 void muensterTPCAnalysisManager::BeginOfRun(const G4Run *pRun) {
+		// in multi-threaded mode the master only merges the worker datafiles (see EndOfRun)
+		if(IsMergingMaster()) {
+			m_iNbEventsToSimulate = pRun->GetNumberOfEventToBeProcessed();
+
+			if(m_hOutputMode == "buffermerger") {
+#ifdef MUENSTERTPC_BUFFERMERGER
+				// the workers fill in-memory files which are merged into this file in the background
+				if(m_iCompressionSettings >= 0)
+					m_pBufferMerger = new muensterTPCBufferMerger(m_hDataFilename.c_str(), "RECREATE", m_iCompressionSettings);
+				else
+					m_pBufferMerger = new muensterTPCBufferMerger(m_hDataFilename.c_str(), "RECREATE");
+#else
+				G4cout << "!!!!> TBufferMerger needs ROOT >= 6.10, using the threadfiles output mode!" << G4endl;
+#endif
+			}
+			return;
+		}
+
 		// do we write empty events or not?
 		writeEmptyEvents = m_pPrimaryGeneratorAction->GetWriteEmpty();
+
+		// integer codes instead of particle and process names?
+		m_bEncodeNames = (m_hEncoding == "code");
+		if(m_bEncodeNames)
+			m_pOutputDictionary->Initialize();
+
+		// the digitizer needs the hit times of the photons
+		m_bDigitizePmtHits = m_pPmtDigitizer->IsEnabled();
+		if(m_bDigitizePmtHits && !muensterTPCPmtSensitiveDetector::IsStoringHits()) {
+			G4cout << "!!!!> digitizer: the photon hit times are not stored, use /Xe/detector/setPmtHits full. Digitizer switched off." << G4endl;
+			m_bDigitizePmtHits = false;
+		}
+		if(m_bDigitizePmtHits)
+			m_pPmtDigitizer->Initialize(GetNbPmts());
+
+		// clusters or steps
+		SelectRunBranches();
+
+		// skipped steps of this run
+		if(GetLXeSensitiveDetector())
+			GetLXeSensitiveDetector()->ResetStatistics();
+
+		// kill volumes and killed tracks of this run
+		if(GetSteppingAction())
+			GetSteppingAction()->Initialize();
+
+		// optical photons killed by the efficiency pre-sampling in this run
+		if(GetStackingAction())
+			GetStackingAction()->ResetStatistics();
+
+		// the lce map is built from tracked photons
+		m_bFastOptics = muensterTPCFastOptics::IsEnabled();
+		if(m_bFastOptics && m_pLceMap->IsEnabled()) {
+			G4cout << "!!!!> fast optics: the photons of an lce map run are tracked. Fast optics switched off." << G4endl;
+			m_bFastOptics = false;
+		}
+		if(m_bFastOptics)
+			m_pFastOptics->Initialize();
+
+		// analytic model of the TPC with the optical properties of this run
+		if(muensterTPCOpticalRayTracer::GetInstance())
+			muensterTPCOpticalRayTracer::GetInstance()->Initialize();
+
+		// acceptance of the filters in this run
+		m_pEventFilter->Initialize((G4int) muensterTPCDetectorConstruction::GetGeometryParameter("NbTopPmts"),
+			(G4int) muensterTPCDetectorConstruction::GetGeometryParameter("NbBottomPmts"));
+
+		// pmtid/pmtcount instead of pmthits?
+		m_bSparsePmtHits = (m_hPmtHitsEncoding == "sparse");
+
+		// the maps are accumulated in memory and written at the end of the run
+		if(m_pLceMap->IsEnabled())
+			m_pLceMap->Initialize((G4int) muensterTPCDetectorConstruction::GetGeometryParameter("NbTopPmts"),
+				(G4int) muensterTPCDetectorConstruction::GetGeometryParameter("NbBottomPmts"), GetNbPmts());
   
 		// create output file
-		m_pTreeFile = new TFile(m_hDataFilename.c_str(), "RECREATE", "File containing event data for muensterTPCsim");
-		TNamed *G4version = new TNamed("G4VERSION_TAG",G4VERSION_TAG);
-		G4version->Write();
-		TNamed *G4MCname = new TNamed("MC_TAG","muensterTPC");
-		G4MCname->Write();
-		TNamed *G4MCVersion = new TNamed("MCVERSION_TAG","X.Y.Z");
-		G4MCname->Write();
+#ifdef MUENSTERTPC_BUFFERMERGER
+		if(G4Threading::IsWorkerThread() && m_pBufferMerger) {
+			// the tags are written by the master after merging
+			m_pBufferMergerFile = m_pBufferMerger->GetFile();
+			m_pTreeFile = m_pBufferMergerFile.get();
+		} else
+#endif
+		{
+			m_pTreeFile = new TFile(m_hDataFilename.c_str(), "RECREATE", "File containing event data for muensterTPCsim");
+			if(m_iCompressionSettings >= 0)
+				m_pTreeFile->SetCompressionSettings(m_iCompressionSettings);
+			WriteDataFileTags();
+		}
 		
+		// in async mode the branches point to the record of the writer thread
+		m_pTreeEventData = m_pEventData;
+		if(m_iAsyncQueueSize > 0) {
+			m_pOutputWriter = new muensterTPCOutputWriter(this, m_iAsyncQueueSize);
+			m_pTreeEventData = m_pOutputWriter->GetTreeEventData();
+		}
+
 		_events = m_pTreeFile->mkdir("events");
 		_events->cd();
 		
@@ -100,32 +257,86 @@ void muensterTPCAnalysisManager::BeginOfRun(const G4Run *pRun) {
 		//					be saved within the same eventid in specific branches (see below).
 		//					Acces to the eventid in ROOT: int eventid;
 		//																				T1->SetBranchAddress("eventid", &eventid);
-		m_pTree->Branch("eventid", &m_pEventData->m_iEventId, "eventid/I");
+		if(IsBranchEnabled("eventid"))
+			m_pTree->Branch("eventid", &m_pTreeEventData->m_iEventId, "eventid/I");
+		// seed0/seed1:	state of the random engine at the start of the event, an event can be
+		//							simulated again with these seeds (see --replay or /run/replayEvent)
+		//							Acces in ROOT: 	Long64_t seed0;
+		//															T1->SetBranchAddress("seed0", &seed0);
+		if(IsBranchEnabled("seed0"))
+			m_pTree->Branch("seed0", &m_pTreeEventData->m_lSeed0, "seed0/L");
+		if(IsBranchEnabled("seed1"))
+			m_pTree->Branch("seed1", &m_pTreeEventData->m_lSeed1, "seed1/L");
+		// postponed:	1 if the primary is a postponed track of a radioactive decay chain (started by an earlier
+		//						event), such events can not be replayed from their seeds
+		//						Acces in ROOT: 	int postponed;
+		//														T1->SetBranchAddress("postponed", &postponed);
+		if(IsBranchEnabled("postponed"))
+			m_pTree->Branch("postponed", &m_pTreeEventData->m_iPostponed, "postponed/I");
 		// ntpmthits:	total amount of top PMT hits for a specific eventid/particle beam
 		//						Acces in ROOT: 	int ntpmthits;
 		//														T1->SetBranchAddress("ntpmthits", &ntpmthits);
-		m_pTree->Branch("ntpmthits", &m_pEventData->m_iNbTopPmtHits, "ntpmthits/I");
+		if(IsBranchEnabled("ntpmthits"))
+			m_pTree->Branch("ntpmthits", &m_pTreeEventData->m_iNbTopPmtHits, "ntpmthits/I");
 		// nbpmthits:	total amount of bottom PMT hits for a specific eventid/particle beam
 		//						Acces in ROOT: 	int nbpmthits;
 		//														T1->SetBranchAddress("nbpmthits", &nbpmthits);
-		m_pTree->Branch("nbpmthits", &m_pEventData->m_iNbBottomPmtHits, "nbpmthits/I");
+		if(IsBranchEnabled("nbpmthits"))
+			m_pTree->Branch("nbpmthits", &m_pTreeEventData->m_iNbBottomPmtHits, "nbpmthits/I");
 
-		//m_pTree->Branch("ntvetopmthits", &m_pEventData->m_iNbTopVetoPmtHits, "ntvetopmthits/I");
-		//m_pTree->Branch("nbvetopmthits", &m_pEventData->m_iNbBottomVetoPmtHits, "nbvetopmthits/I");
+		//m_pTree->Branch("ntvetopmthits", &m_pTreeEventData->m_iNbTopVetoPmtHits, "ntvetopmthits/I");
+		//m_pTree->Branch("nbvetopmthits", &m_pTreeEventData->m_iNbBottomVetoPmtHits, "nbvetopmthits/I");
 
 		// pmthits:	total amount of PMT hits for a specific eventid and for each PMT
 		//						Acces in ROOT: 	vector<int> *pmthits= new vector<int>;
 		//														T1->SetBranchAddress("pmthits", &pmthits);
 		//						Note: Do not access pmthits without calling a specifig vector element.
-		m_pTree->Branch("pmthits", "vector<int>", &m_pEventData->m_pPmtHits);
+		// pmtid/pmtcount:	with /Xe/output/pmtHits sparse only the pmts with hits and their number of hits,
+		//									pmthits can be restored with muensterTPCOutputReader::ExpandPmtHits
+		//									Acces in ROOT: 	vector<int> *pmtid= new vector<int>;
+		//																	T1->SetBranchAddress("pmtid", &pmtid);
+		if(IsBranchEnabled("pmthits")) {
+			if(m_bSparsePmtHits) {
+				m_pTree->Branch("pmtid", "vector<int>", &m_pTreeEventData->m_pPmtId);
+				m_pTree->Branch("pmtcount", "vector<int>", &m_pTreeEventData->m_pPmtCount);
+			}
+			else
+				m_pTree->Branch("pmthits", "vector<int>", &m_pTreeEventData->m_pPmtHits);
+		}
+		// pmttiming:	with /Xe/detector/setPmtTimeHistograms one row of 1+nbins values per pmt, in the order of
+		//						pmthits (all pmts) or pmtid (sparse): first photon time [ns] (-1 without photon) and the
+		//						photon arrival time histogram, binning in events/pmttimingbins, pmttimingmin and pmttimingmax [ns]
+		//						Acces in ROOT: 	vector<float> *pmttiming= new vector<float>;
+		//														T1->SetBranchAddress("pmttiming", &pmttiming);
+		if(IsBranchEnabled("pmttiming"))
+			m_pTree->Branch("pmttiming", "vector<float>", &m_pTreeEventData->m_pPmtTiming);
+		// pmtarea:	with /Xe/output/digitizer/mode area the pulse area of the digitized waveform per pmt [pe],
+		//					in the order of pmthits (all pmts) or pmtid (sparse)
+		//					Acces in ROOT: 	vector<float> *pmtarea= new vector<float>;
+		//													T1->SetBranchAddress("pmtarea", &pmtarea);
+		if(IsBranchEnabled("pmtarea"))
+			m_pTree->Branch("pmtarea", "vector<float>", &m_pTreeEventData->m_pPmtArea);
+		// wfpmt, wfstart, wflength, wfdata:	with /Xe/output/digitizer/mode zle the zero suppressed waveforms [pe/sample],
+		//																		pmt, first sample and number of samples of each segment, the samples of
+		//																		all segments in wfdata, sampling in events/digitizersampling and digitizerstart [ns]
+		if(IsBranchEnabled("wfpmt"))
+			m_pTree->Branch("wfpmt", "vector<int>", &m_pTreeEventData->m_pWaveformPmt);
+		if(IsBranchEnabled("wfstart"))
+			m_pTree->Branch("wfstart", "vector<int>", &m_pTreeEventData->m_pWaveformStart);
+		if(IsBranchEnabled("wflength"))
+			m_pTree->Branch("wflength", "vector<int>", &m_pTreeEventData->m_pWaveformLength);
+		if(IsBranchEnabled("wfdata"))
+			m_pTree->Branch("wfdata", "vector<float>", &m_pTreeEventData->m_pWaveformData);
 		// etot:	Amount of energy, which is deopsited during this eventid/particle run.
 		//				Acces in ROOT: 	float etot;
 		//												T1->SetBranchAddress("etot", &etot);
-		m_pTree->Branch("etot", &m_pEventData->m_fTotalEnergyDeposited, "etot/F");
+		if(IsBranchEnabled("etot"))
+			m_pTree->Branch("etot", &m_pTreeEventData->m_fTotalEnergyDeposited, "etot/F");
 		// nbpmthits:	total amount of bottom PMT hits for a specific eventid/particle beam
 		//						Acces in ROOT: 	int nbpmthits;
 		//														T1->SetBranchAddress("nbpmthits", &nbpmthits);
-		m_pTree->Branch("nsteps", &m_pEventData->m_iNbSteps, "nsteps/I");
+		if(IsBranchEnabled("nsteps"))
+			m_pTree->Branch("nsteps", &m_pTreeEventData->m_iNbSteps, "nsteps/I");
 	
 		//******************************************************************/	
 		// branches for each event/particle which is created by the main event
@@ -134,45 +345,108 @@ void muensterTPCAnalysisManager::BeginOfRun(const G4Run *pRun) {
 		//					generated within the main eventid. (e.g. emitted gammas)
 		//					Acces in ROOT: 	vector<int> *trackid= new vector<int>;
 		//													T1->SetBranchAddress("trackid", &trackid);
-		m_pTree->Branch("trackid", "vector<int>", &m_pEventData->m_pTrackId);
+		if(IsBranchEnabled("trackid"))
+			m_pTree->Branch("trackid", "vector<int>", &m_pTreeEventData->m_pTrackId);
 		// type:	type of the particles in the event track
 		//				Acces in ROOT: 	vector<string> *type= new vector<string>;
 		//												T1->SetBranchAddress("type", &type);
-		m_pTree->Branch("type", "vector<string>", &m_pEventData->m_pParticleType);
+		//				With /Xe/output/encoding code the type, parenttype, creaproc, edproc and type_pri
+		//				branches are vector<int> (PDG codes and process ids), the names are stored in the
+		//				trees events/typedict and events/procdict (see muensterTPCOutputReader.hh).
+		if(IsBranchEnabled("type")) {
+			if(m_bEncodeNames)
+				m_pTree->Branch("type", "vector<int>", &m_pTreeEventData->m_pParticleTypeCode);
+			else
+				m_pTree->Branch("type", "vector<string>", &m_pTreeEventData->m_pParticleType);
+		}
 		// parentid:	trackid of the parent track event
 		//						Acces in ROOT: 	vector<int> *parentid= new vector<int>;
 		//														T1->SetBranchAddress("parentid", &parentid);
-		m_pTree->Branch("parentid", "vector<int>", &m_pEventData->m_pParentId);
+		if(IsBranchEnabled("parentid"))
+			m_pTree->Branch("parentid", "vector<int>", &m_pTreeEventData->m_pParentId);
 		// parenttype:	parenttype of the parent track event
 		//							Acces in ROOT: 	vector<string> *parenttype= new vector<string>;
 		//															T1->SetBranchAddress("parenttype", &parenttype);
-		m_pTree->Branch("parenttype", "vector<string>", &m_pEventData->m_pParentType);
+		if(IsBranchEnabled("parenttype")) {
+			if(m_bEncodeNames)
+				m_pTree->Branch("parenttype", "vector<int>", &m_pTreeEventData->m_pParentTypeCode);
+			else
+				m_pTree->Branch("parenttype", "vector<string>", &m_pTreeEventData->m_pParentType);
+		}
 		// creaproc:	name of the creation process of the track particle/trackid
 		//						Acces in ROOT: 	vector<string> *creaproc= new vector<string>;
 		//														T1->SetBranchAddress("creaproc", &creaproc);
-		m_pTree->Branch("creaproc", "vector<string>", &m_pEventData->m_pCreatorProcess);
+		if(IsBranchEnabled("creaproc")) {
+			if(m_bEncodeNames)
+				m_pTree->Branch("creaproc", "vector<int>", &m_pTreeEventData->m_pCreatorProcessCode);
+			else
+				m_pTree->Branch("creaproc", "vector<string>", &m_pTreeEventData->m_pCreatorProcess);
+		}
 		// edproc:	name of the energy deposition process of the track particle/trackid
 		//					Acces in ROOT: 	vector<string> *edproc= new vector<string>;
 		//													T1->SetBranchAddress("edproc", &edproc);
-		m_pTree->Branch("edproc", "vector<string>", &m_pEventData->m_pDepositingProcess);
+		if(IsBranchEnabled("edproc")) {
+			if(m_bEncodeNames)
+				m_pTree->Branch("edproc", "vector<int>", &m_pTreeEventData->m_pDepositingProcessCode);
+			else
+				m_pTree->Branch("edproc", "vector<string>", &m_pTreeEventData->m_pDepositingProcess);
+		}
 		// Positions of the current particle/trackid
 		// 		Acces in ROOT: 		vector<float> *xp= new vector<float>;
 		//											T1->SetBranchAddress("xp", &xp);
-		m_pTree->Branch("xp", "vector<float>", &m_pEventData->m_pX);
+		if(IsBranchEnabled("xp"))
+			m_pTree->Branch("xp", "vector<float>", &m_pTreeEventData->m_pX);
 		// 		Acces in ROOT: 		vector<float> *yp= new vector<float>;
 		//											T1->SetBranchAddress("yp", &yp);
-		m_pTree->Branch("yp", "vector<float>", &m_pEventData->m_pY);
+		if(IsBranchEnabled("yp"))
+			m_pTree->Branch("yp", "vector<float>", &m_pTreeEventData->m_pY);
 		// 		Acces in ROOT: 		vector<float> *zp= new vector<float>;
 		//											T1->SetBranchAddress("zp", &zp);
-		m_pTree->Branch("zp", "vector<float>", &m_pEventData->m_pZ);
+		if(IsBranchEnabled("zp"))
+			m_pTree->Branch("zp", "vector<float>", &m_pTreeEventData->m_pZ);
 		// ed:	energy deposition of the current particle/trackid
 		// 			Acces in ROOT: 		vector<float> *ed= new vector<float>;
 		//												T1->SetBranchAddress("ed", &ed);
-		m_pTree->Branch("ed", "vector<float>", &m_pEventData->m_pEnergyDeposited);
+		if(IsBranchEnabled("ed"))
+			m_pTree->Branch("ed", "vector<float>", &m_pTreeEventData->m_pEnergyDeposited);
 		// time:	timestamp of the current particle/trackid
 		// 				Acces in ROOT: 		vector<float> *time= new vector<float>;
 		//													T1->SetBranchAddress("time", &time);
-		m_pTree->Branch("time", "vector<double>", &m_pEventData->m_pTime);
+		if(IsBranchEnabled("time"))
+			m_pTree->Branch("time", "vector<float>", &m_pTreeEventData->m_pTime);
+
+		//******************************************************************/	
+		// branches for each cluster (/Xe/detector/setLXeClustering), they replace the step branches above
+		//******************************************************************/
+		// nclusters:	number of clusters
+		// trackidc, typec:	track id and type of the first step of the cluster
+		// xc, yc, zc, timec:	energy weighted position and time of the cluster
+		// edc:	energy deposited in the cluster
+		// nstepsc:	number of merged steps
+		// 		Acces in ROOT: 		vector<float> *edc= new vector<float>;
+		//											T1->SetBranchAddress("edc", &edc);
+		if(IsBranchEnabled("nclusters"))
+			m_pTree->Branch("nclusters", &m_pTreeEventData->m_iNbClusters, "nclusters/I");
+		if(IsBranchEnabled("trackidc"))
+			m_pTree->Branch("trackidc", "vector<int>", &m_pTreeEventData->m_pClusterTrackId);
+		if(IsBranchEnabled("typec")) {
+			if(m_bEncodeNames)
+				m_pTree->Branch("typec", "vector<int>", &m_pTreeEventData->m_pClusterTypeCode);
+			else
+				m_pTree->Branch("typec", "vector<string>", &m_pTreeEventData->m_pClusterType);
+		}
+		if(IsBranchEnabled("xc"))
+			m_pTree->Branch("xc", "vector<float>", &m_pTreeEventData->m_pClusterX);
+		if(IsBranchEnabled("yc"))
+			m_pTree->Branch("yc", "vector<float>", &m_pTreeEventData->m_pClusterY);
+		if(IsBranchEnabled("zc"))
+			m_pTree->Branch("zc", "vector<float>", &m_pTreeEventData->m_pClusterZ);
+		if(IsBranchEnabled("edc"))
+			m_pTree->Branch("edc", "vector<float>", &m_pTreeEventData->m_pClusterEnergyDeposited);
+		if(IsBranchEnabled("timec"))
+			m_pTree->Branch("timec", "vector<float>", &m_pTreeEventData->m_pClusterTime);
+		if(IsBranchEnabled("nstepsc"))
+			m_pTree->Branch("nstepsc", "vector<int>", &m_pTreeEventData->m_pClusterNbSteps);
 
 		//******************************************************************/	
 		// branches for each event/particle which contain information about the primary particle
@@ -180,35 +454,168 @@ void muensterTPCAnalysisManager::BeginOfRun(const G4Run *pRun) {
 		// type_pri:	type of the primary event/main event
 		//						Acces in ROOT: 	vector<string> *type_pri= new vector<string>;
 		//														T1->SetBranchAddress("type_pri", &type_pri);
-		m_pTree->Branch("type_pri", "vector<string>", &m_pEventData->m_pPrimaryParticleType);
+		if(IsBranchEnabled("type_pri")) {
+			if(m_bEncodeNames)
+				m_pTree->Branch("type_pri", "vector<int>", &m_pTreeEventData->m_pPrimaryParticleTypeCode);
+			else
+				m_pTree->Branch("type_pri", "vector<string>", &m_pTreeEventData->m_pPrimaryParticleType);
+		}
 		// Energy and positions of the current particle/trackid
 		// 		Acces in ROOT:	vector<float> *e_pri= new vector<float>;
 		//										T1->SetBranchAddress("e_pri", &e_pri);
-		m_pTree->Branch("e_pri", &m_pEventData->m_fPrimaryEnergy, "e_pri/F");
+		if(IsBranchEnabled("e_pri"))
+			m_pTree->Branch("e_pri", &m_pTreeEventData->m_fPrimaryEnergy, "e_pri/F");
 		// 		Acces in ROOT:	vector<float> *xp_pri= new vector<float>;
 		//										T1->SetBranchAddress("xp_pri", &xp_pri);
-		m_pTree->Branch("xp_pri", &m_pEventData->m_fPrimaryX, "xp_pri/F");
+		if(IsBranchEnabled("xp_pri"))
+			m_pTree->Branch("xp_pri", &m_pTreeEventData->m_fPrimaryX, "xp_pri/F");
 		// 		Acces in ROOT:	vector<float> *yp_pri= new vector<float>;
 		//										T1->SetBranchAddress("yp_pri", &yp_pri);	
-		m_pTree->Branch("yp_pri", &m_pEventData->m_fPrimaryY, "yp_pri/F");
+		if(IsBranchEnabled("yp_pri"))
+			m_pTree->Branch("yp_pri", &m_pTreeEventData->m_fPrimaryY, "yp_pri/F");
 		// 		Acces in ROOT:	vector<float> *zp_pri= new vector<float>;
 		//										T1->SetBranchAddress("zp_pri", &zp_pri);
-		m_pTree->Branch("zp_pri", &m_pEventData->m_fPrimaryZ, "zp_pri/F");
+		if(IsBranchEnabled("zp_pri"))
+			m_pTree->Branch("zp_pri", &m_pTreeEventData->m_fPrimaryZ, "zp_pri/F");
 
 		//m_pTree->SetMaxTreeSize(10e9); /previous
 		m_pTree->SetMaxTreeSize(1000*Long64_t(2000000000)); //2TB
-		m_pTree->AutoSave();
+		// basket sizes, "*" sorts before the branch names and is applied first
+		for(map<G4String, G4int>::iterator pIt = m_hBasketSizes.begin(); pIt != m_hBasketSizes.end(); pIt++)
+			m_pTree->SetBasketSize(pIt->first.c_str(), pIt->second);
+
+		// auto save after a number of bytes is done by ROOT (negative value = bytes)
+		if(m_hAutoSaveUnit == "bytes" && !IsBufferMergerFile())
+			m_pTree->SetAutoSave(-(Long64_t) m_dAutoSave);
+		m_iNbEventsSinceAutoSave = 0;
+		m_hLastAutoSaveTime = time(0);
+		m_dWriteTime = 0.;
+		m_dCollectTime = 0.;
+		m_iNbCollectedEvents = 0;
+
+		if(!IsBufferMergerFile())
+			m_pTree->AutoSave();
+
+		if(m_pOutputWriter)
+			m_pOutputWriter->Start();
 	
 		// Write the number of events in the output file
 		m_iNbEventsToSimulate = pRun->GetNumberOfEventToBeProcessed();
 		m_pNbEventsToSimulateParameter = new TParameter<int>("nbevents", m_iNbEventsToSimulate);
-		m_pNbEventsToSimulateParameter->Write();
+		// the number of events is summed up when datafiles are merged
+		m_pNbEventsToSimulateParameter->SetMergeMode('+');
+		// every buffer write is merged, so this is only written once at the end of the run
+		if(!IsBufferMergerFile())
+			m_pNbEventsToSimulateParameter->Write();
 }
 
 //******************************************************************/
 // EndOfRun action/end of the simulation
 //******************************************************************/
 void muensterTPCAnalysisManager::EndOfRun(const G4Run *pRun) {
+		// the master merges the worker datafiles after all workers have finished
+		if(IsMergingMaster()) {
+#ifdef MUENSTERTPC_BUFFERMERGER
+			if(m_pBufferMerger) {
+				// waits until the queued buffers of all workers are written
+				delete m_pBufferMerger;
+				m_pBufferMerger = 0;
+
+				TFile *pDataFile = new TFile(m_hDataFilename.c_str(), "UPDATE");
+				WriteDataFileTags();
+				muensterTPCLceMap::UpdateMaps(pDataFile);
+				pDataFile->Close();
+				delete pDataFile;
+				return;
+			}
+#endif
+			MergeWorkerDataFiles();
+			return;
+		}
+
+		// write the queued events
+		if(m_pOutputWriter) {
+			m_pOutputWriter->Stop();
+			m_pOutputWriter->PrintStatistics();
+			delete m_pOutputWriter;
+			m_pOutputWriter = 0;
+			m_pTreeEventData = m_pEventData;
+		}
+
+		// dictionaries of the particle and process codes
+		if(m_bEncodeNames) {
+			_events->cd();
+			m_pOutputDictionary->Write();
+		}
+
+		// light collection efficiency maps
+		if(m_pLceMap->IsEnabled())
+			m_pLceMap->Write(m_pTreeFile);
+
+		// number of pmts to expand pmtid/pmtcount, the same in all merged files
+		if(m_bSparsePmtHits) {
+			TParameter<int> hNbPmtsParameter("nbpmts", GetNbPmts());
+			hNbPmtsParameter.SetMergeMode('M');
+			_events->cd();
+			hNbPmtsParameter.Write(0, TObject::kOverwrite);
+		}
+
+		// binning of pmttiming, the same in all merged files
+		if(IsBranchEnabled("pmttiming")) {
+			_events->cd();
+			TParameter<int> hNbTimeBinsParameter("pmttimingbins", muensterTPCPmtSensitiveDetector::GetNbTimeBins());
+			hNbTimeBinsParameter.SetMergeMode('M');
+			hNbTimeBinsParameter.Write(0, TObject::kOverwrite);
+			TParameter<double> hTimeMinParameter("pmttimingmin", muensterTPCPmtSensitiveDetector::GetTimeMin()/ns);
+			hTimeMinParameter.SetMergeMode('M');
+			hTimeMinParameter.Write(0, TObject::kOverwrite);
+			TParameter<double> hTimeMaxParameter("pmttimingmax", muensterTPCPmtSensitiveDetector::GetTimeMax()/ns);
+			hTimeMaxParameter.SetMergeMode('M');
+			hTimeMaxParameter.Write(0, TObject::kOverwrite);
+		}
+
+		// sampling of the zero suppressed waveforms, the same in all merged files
+		if(IsBranchEnabled("wfdata")) {
+			_events->cd();
+			TParameter<double> hSamplingParameter("digitizersampling", m_pPmtDigitizer->GetSamplingPeriod()/ns);
+			hSamplingParameter.SetMergeMode('M');
+			hSamplingParameter.Write(0, TObject::kOverwrite);
+			TParameter<double> hStartParameter("digitizerstart", m_pPmtDigitizer->GetWindowStart()/ns);
+			hStartParameter.SetMergeMode('M');
+			hStartParameter.Write(0, TObject::kOverwrite);
+		}
+
+		// a worker thread only processed a part of the events of this run
+		if(G4Threading::IsWorkerThread()) {
+			m_pNbEventsToSimulateParameter->SetVal(pRun->GetNumberOfEvent());
+			_events->cd();
+			m_pNbEventsToSimulateParameter->Write(0, TObject::kOverwrite);
+		}
+
+		PrintOutputStatistics();
+		if(GetLXeSensitiveDetector())
+			GetLXeSensitiveDetector()->PrintStatistics();
+		m_pEventFilter->PrintStatistics();
+		if(GetSteppingAction())
+			GetSteppingAction()->PrintStatistics();
+		if(GetStackingAction())
+			GetStackingAction()->PrintStatistics();
+		if(m_bFastOptics)
+			m_pFastOptics->PrintStatistics();
+		if(muensterTPCOpticalRayTracer::GetInstance())
+			muensterTPCOpticalRayTracer::GetInstance()->PrintStatistics();
+
+#ifdef MUENSTERTPC_BUFFERMERGER
+		if(IsBufferMergerFile()) {
+			// hand the remaining events to the merger, the tree is owned by the buffer file
+			m_pBufferMergerFile->Write();
+			m_pBufferMergerFile.reset();
+			m_pTreeFile = 0;
+			m_pTree = 0;
+			return;
+		}
+#endif
+
 		// write and remove old revisions
 		m_pTreeFile->Write(0,TObject::kOverwrite);
 		//m_pTreeFile->Write();
@@ -221,11 +628,11 @@ void muensterTPCAnalysisManager::EndOfRun(const G4Run *pRun) {
 void muensterTPCAnalysisManager::BeginOfEvent(const G4Event *pEvent) {
 	// initialize the HitCollections if needed (-1 = not initialized)
 	//G4cout << "Begin of Event" << G4endl;
-	if(m_iLXeHitsCollectionID == -1)
+	if(m_iLXeClustersCollectionID == -1)
 	{
 		G4SDManager *pSDManager = G4SDManager::GetSDMpointer();
-		m_iLXeHitsCollectionID = pSDManager->GetCollectionID("LXeHitsCollection");
-	} 
+		m_iLXeClustersCollectionID = pSDManager->GetCollectionID("LXeClustersCollection");
+	}
 
 	if(m_iPmtHitsCollectionID == -1)
 	{
@@ -238,30 +645,93 @@ void muensterTPCAnalysisManager::BeginOfEvent(const G4Event *pEvent) {
 // EndOfEvent action - getting all event data
 //******************************************************************/
 void muensterTPCAnalysisManager::EndOfEvent(const G4Event *pEvent) {
+	m_hCollectTimer.Start();
+
 	G4HCofThisEvent* pHCofThisEvent = pEvent->GetHCofThisEvent();
-	muensterTPCLXeHitsCollection* pLXeHitsCollection = 0;
+	muensterTPCLXeHitStore* pLXeHitStore = 0;
+	muensterTPCLXeClustersCollection* pLXeClustersCollection = 0;
 	muensterTPCPmtHitsCollection* pPmtHitsCollection = 0;
 
-	G4int iNbLXeHits = 0, iNbPmtHits = 0;
+	G4int iNbLXeHits = 0, iNbPmtHits = 0, iNbLXeClusters = 0;
+
+	// the hits per pmt are counted by the sensitive detector, the hits collection is only filled with /Xe/detector/setPmtHits full
+	muensterTPCPmtSensitiveDetector *pPmtSD = GetPmtSensitiveDetector();
+	if(m_bFastOptics)
+		m_pFastOptics->EndOfEvent(pPmtSD);
+	if(muensterTPCOpticalRayTracer::GetInstance())
+		muensterTPCOpticalRayTracer::GetInstance()->EndOfEvent();
+	if(pPmtSD)
+		iNbPmtHits = pPmtSD->GetNbHits();
+
+	// the steps in the LXe/GXe are stored as arrays by the sensitive detector
+	muensterTPCLXeSensitiveDetector *pLXeSD = GetLXeSensitiveDetector();
+	if(pLXeSD) {
+		pLXeHitStore = pLXeSD->GetHitStore();
+		iNbLXeHits = pLXeHitStore->GetNbHits();
+	}
 	
 	if(pHCofThisEvent)
 	{
-		if(m_iLXeHitsCollectionID != -1)
+		if(m_iLXeClustersCollectionID != -1)
 		{
-			pLXeHitsCollection = (muensterTPCLXeHitsCollection *)(pHCofThisEvent->GetHC(m_iLXeHitsCollectionID));
-			iNbLXeHits = (pLXeHitsCollection)?(pLXeHitsCollection->entries()):(0);
+			pLXeClustersCollection = (muensterTPCLXeClustersCollection *)(pHCofThisEvent->GetHC(m_iLXeClustersCollectionID));
+			iNbLXeClusters = (pLXeClustersCollection)?(pLXeClustersCollection->entries()):(0);
 		}
 
+		// only filled with /Xe/detector/setPmtHits full
 		if(m_iPmtHitsCollectionID != -1)
-		{
 			pPmtHitsCollection = (muensterTPCPmtHitsCollection *)(pHCofThisEvent->GetHC(m_iPmtHitsCollectionID));
-			iNbPmtHits = (pPmtHitsCollection)?(pPmtHitsCollection->entries()):(0);
-		}
 	}
 
-	m_pEventData->m_iEventId = pEvent->GetEventID();
+	// replayed events keep their original event id
+	if(m_pPrimaryGeneratorAction->GetReplayEventId() >= 0)
+		m_pEventData->m_iEventId = m_pPrimaryGeneratorAction->GetReplayEventId();
+	else
+		m_pEventData->m_iEventId = pEvent->GetEventID() + m_iEventIdOffset;
+	m_pEventData->m_lSeed0 = m_pPrimaryGeneratorAction->GetEventSeeds()[0];
+	m_pEventData->m_lSeed1 = m_pPrimaryGeneratorAction->GetEventSeeds()[1];
+	m_pEventData->m_iPostponed = (m_pPrimaryGeneratorAction->IsFromPostponedStack())?(1):(0);
+
+	// lce map mode: the photons of the event are counted at the emission position, no tree entries
+	if(m_pLceMap->IsEnabled()) {
+		G4int iNbEmitted = 0;
+		for(G4int i=0; i<pEvent->GetNumberOfPrimaryVertex(); i++)
+			iNbEmitted += pEvent->GetPrimaryVertex(i)->GetNumberOfParticle();
+
+		if(pPmtSD)
+			m_pLceMap->Fill(m_pPrimaryGeneratorAction->GetPositionOfPrimary(), iNbEmitted, pPmtSD->GetHitPmts(), pPmtSD->GetPmtCounts());
+		StopCollectTimer();
+		return;
+	}
+
+	// rejected events are neither gathered nor written (see /Xe/output/filter/)
+	if(m_pEventFilter->IsEnabled() && !m_pEventFilter->Accept(m_pPrimaryGeneratorAction->GetParticleTypeOfPrimary(),
+		pLXeHitStore, pLXeClustersCollection, pPmtSD)) {
+		m_pEventData->Clear();
+		StopCollectTimer();
+		return;
+	}
 
-	m_pEventData->m_pPrimaryParticleType->push_back(m_pPrimaryGeneratorAction->GetParticleTypeOfPrimary());
+	// only the data of enabled branches is gathered (see /Xe/output/profile)
+	G4bool bTrackId = IsBranchEnabled("trackid"), bParentId = IsBranchEnabled("parentid");
+	G4bool bType = IsBranchEnabled("type"), bParentType = IsBranchEnabled("parenttype");
+	G4bool bCreatorProcess = IsBranchEnabled("creaproc"), bDepositingProcess = IsBranchEnabled("edproc");
+	G4bool bX = IsBranchEnabled("xp"), bY = IsBranchEnabled("yp"), bZ = IsBranchEnabled("zp");
+	G4bool bEnergyDeposited = IsBranchEnabled("ed"), bTime = IsBranchEnabled("time");
+	G4bool bPmtHits = IsBranchEnabled("pmthits") || IsBranchEnabled("ntpmthits") || IsBranchEnabled("nbpmthits");
+	G4bool bPmtTiming = IsBranchEnabled("pmttiming");
+	G4bool bPmtArea = IsBranchEnabled("pmtarea");
+	G4bool bClusterTrackId = IsBranchEnabled("trackidc"), bClusterType = IsBranchEnabled("typec");
+	G4bool bClusterX = IsBranchEnabled("xc"), bClusterY = IsBranchEnabled("yc"), bClusterZ = IsBranchEnabled("zc");
+	G4bool bClusterEnergyDeposited = IsBranchEnabled("edc"), bClusterTime = IsBranchEnabled("timec");
+	G4bool bClusterNbSteps = IsBranchEnabled("nstepsc");
+
+	if(IsBranchEnabled("type_pri")) {
+		if(m_bEncodeNames)
+			m_pEventData->m_pPrimaryParticleTypeCode->push_back(m_pOutputDictionary->GetParticleCode(m_pPrimaryGeneratorAction->GetParticleTypeOfPrimary()));
+		else
+			m_pEventData->PushBack(m_pEventData->m_pPrimaryParticleType, m_pPrimaryGeneratorAction->GetParticleTypeOfPrimary());
+	}
 
 	m_pEventData->m_fPrimaryEnergy = m_pPrimaryGeneratorAction->GetEnergyOfPrimary()/keV;
 	m_pEventData->m_fPrimaryX = m_pPrimaryGeneratorAction->GetPositionOfPrimary().x()/mm;
@@ -271,36 +741,75 @@ void muensterTPCAnalysisManager::EndOfEvent(const G4Event *pEvent) {
 	G4int iNbSteps = 0;
 	G4float fTotalEnergyDeposited = 0.;
 	
-	if(iNbLXeHits || iNbPmtHits)
+	if(iNbLXeHits || iNbPmtHits || iNbLXeClusters)
 	{
-		// LXe hits
-		for(G4int i=0; i<iNbLXeHits; i++)
-		{
-			muensterTPCLXeHit *pHit = (*pLXeHitsCollection)[i];
+		// LXe steps, optical photons and steps below the threshold are rejected by the sensitive detector,
+		// the arrays are copied (and converted) as a whole
+		if(iNbLXeHits) {
+			if(bTrackId) m_pEventData->m_pTrackId->insert(m_pEventData->m_pTrackId->end(), pLXeHitStore->GetTrackIds().begin(), pLXeHitStore->GetTrackIds().end());
+			if(bParentId) m_pEventData->m_pParentId->insert(m_pEventData->m_pParentId->end(), pLXeHitStore->GetParentIds().begin(), pLXeHitStore->GetParentIds().end());
 
-			if(pHit->GetParticleType() != "opticalphoton")
-			{
-				m_pEventData->m_pTrackId->push_back(pHit->GetTrackId());
-				m_pEventData->m_pParentId->push_back(pHit->GetParentId());
+			const vector<const G4ParticleDefinition *> &hParticleDefinitions = pLXeHitStore->GetParticleDefinitions();
+			const vector<const G4ParticleDefinition *> &hParentDefinitions = pLXeHitStore->GetParentDefinitions();
+			const vector<const G4VProcess *> &hCreatorProcesses = pLXeHitStore->GetCreatorProcesses();
+			const vector<const G4VProcess *> &hDepositingProcesses = pLXeHitStore->GetDepositingProcesses();
 
-				m_pEventData->m_pParticleType->push_back(pHit->GetParticleType());
-				m_pEventData->m_pParentType->push_back(pHit->GetParentType());
-				m_pEventData->m_pCreatorProcess->push_back(pHit->GetCreatorProcess());
-				m_pEventData->m_pDepositingProcess->push_back(pHit->GetDepositingProcess());
+			for(G4int i=0; i<iNbLXeHits; i++) {
+				if(m_bEncodeNames) {
+					if(bType) m_pEventData->m_pParticleTypeCode->push_back(m_pOutputDictionary->GetParticleCode(hParticleDefinitions[i]));
+					if(bParentType) m_pEventData->m_pParentTypeCode->push_back(m_pOutputDictionary->GetParticleCode(hParentDefinitions[i]));
+					if(bCreatorProcess) m_pEventData->m_pCreatorProcessCode->push_back(m_pOutputDictionary->GetProcessCode(hCreatorProcesses[i]));
+					if(bDepositingProcess) m_pEventData->m_pDepositingProcessCode->push_back(m_pOutputDictionary->GetProcessCode(hDepositingProcesses[i]));
+				} else {
+					if(bType) m_pEventData->PushBack(m_pEventData->m_pParticleType, muensterTPCLXeHitStore::GetParticleName(hParticleDefinitions[i]));
+					if(bParentType) m_pEventData->PushBack(m_pEventData->m_pParentType, muensterTPCLXeHitStore::GetParticleName(hParentDefinitions[i]));
+					if(bCreatorProcess) m_pEventData->PushBack(m_pEventData->m_pCreatorProcess, muensterTPCLXeHitStore::GetProcessName(hCreatorProcesses[i]));
+					if(bDepositingProcess) m_pEventData->PushBack(m_pEventData->m_pDepositingProcess, muensterTPCLXeHitStore::GetProcessName(hDepositingProcesses[i]));
+				}
+			}
 
-				m_pEventData->m_pX->push_back(pHit->GetPosition().x()/mm);
-				m_pEventData->m_pY->push_back(pHit->GetPosition().y()/mm);
-				m_pEventData->m_pZ->push_back(pHit->GetPosition().z()/mm);
+			if(bX) muensterTPCLXeHitStore::AppendInUnit(pLXeHitStore->GetX(), mm, m_pEventData->m_pX);
+			if(bY) muensterTPCLXeHitStore::AppendInUnit(pLXeHitStore->GetY(), mm, m_pEventData->m_pY);
+			if(bZ) muensterTPCLXeHitStore::AppendInUnit(pLXeHitStore->GetZ(), mm, m_pEventData->m_pZ);
+			if(bEnergyDeposited) muensterTPCLXeHitStore::AppendInUnit(pLXeHitStore->GetEnergiesDeposited(), keV, m_pEventData->m_pEnergyDeposited);
+			if(bTime) muensterTPCLXeHitStore::AppendInUnit(pLXeHitStore->GetTimes(), second, m_pEventData->m_pTime);
 
-				fTotalEnergyDeposited += pHit->GetEnergyDeposited()/keV;
-				m_pEventData->m_pEnergyDeposited->push_back(pHit->GetEnergyDeposited()/keV);
+			// etot is always summed up, it decides whether the event is written
+			const vector<float> &hEnergiesDeposited = pLXeHitStore->GetEnergiesDeposited();
+			G4double dEnergyDeposited = 0.;
+			for(G4int i=0; i<iNbLXeHits; i++)
+				dEnergyDeposited += hEnergiesDeposited[i];
+			fTotalEnergyDeposited += dEnergyDeposited/keV;
 
-				m_pEventData->m_pKineticEnergy->push_back(pHit->GetKineticEnergy()/keV);
-				m_pEventData->m_pTime->push_back(pHit->GetTime()/second);
+			iNbSteps += iNbLXeHits;
+		}
+
+		// LXe clusters (only with /Xe/detector/setLXeClustering)
+		for(G4int i=0; i<iNbLXeClusters; i++)
+		{
+			muensterTPCLXeCluster *pCluster = (*pLXeClustersCollection)[i];
 
-				iNbSteps++;
+			if(bClusterTrackId) m_pEventData->m_pClusterTrackId->push_back(pCluster->GetTrackId());
+			if(bClusterType) {
+				if(m_bEncodeNames)
+					m_pEventData->m_pClusterTypeCode->push_back(m_pOutputDictionary->GetParticleCode(pCluster->GetParticleDefinition()));
+				else
+					m_pEventData->PushBack(m_pEventData->m_pClusterType, pCluster->GetParticleDefinition()->GetParticleName());
 			}
+
+			G4ThreeVector hPosition = pCluster->GetPosition();
+			if(bClusterX) m_pEventData->m_pClusterX->push_back(hPosition.x()/mm);
+			if(bClusterY) m_pEventData->m_pClusterY->push_back(hPosition.y()/mm);
+			if(bClusterZ) m_pEventData->m_pClusterZ->push_back(hPosition.z()/mm);
+
+			fTotalEnergyDeposited += pCluster->GetEnergyDeposited()/keV;
+			if(bClusterEnergyDeposited) m_pEventData->m_pClusterEnergyDeposited->push_back(pCluster->GetEnergyDeposited()/keV);
+			if(bClusterTime) m_pEventData->m_pClusterTime->push_back(pCluster->GetTime()/second);
+			if(bClusterNbSteps) m_pEventData->m_pClusterNbSteps->push_back(pCluster->GetNbSteps());
+
+			iNbSteps += pCluster->GetNbSteps();
 		}
+		m_pEventData->m_iNbClusters = iNbLXeClusters;
 
 		m_pEventData->m_iNbSteps = iNbSteps;
 		m_pEventData->m_fTotalEnergyDeposited = fTotalEnergyDeposited;
@@ -310,32 +819,89 @@ void muensterTPCAnalysisManager::EndOfEvent(const G4Event *pEvent) {
 		G4int iNbTopVetoPmts = (G4int) muensterTPCDetectorConstruction::GetGeometryParameter("NbTopVetoPmts");
 		G4int iNbBottomVetoPmts = (G4int) muensterTPCDetectorConstruction::GetGeometryParameter("NbBottomVetoPmts");
 
-		m_pEventData->m_pPmtHits->resize(iNbTopPmts+iNbBottomPmts+iNbTopVetoPmts+iNbBottomVetoPmts, 0);
+		if((bPmtHits || bPmtTiming || bPmtArea) && m_bSparsePmtHits && pPmtSD) {
+			// only the hit pmts, in ascending order
+			m_pEventData->m_pPmtId->assign(pPmtSD->GetHitPmts().begin(), pPmtSD->GetHitPmts().end());
+			sort(m_pEventData->m_pPmtId->begin(), m_pEventData->m_pPmtId->end());
+
+			for(size_t i=0; i<m_pEventData->m_pPmtId->size(); i++) {
+				G4int iPmtNb = (*(m_pEventData->m_pPmtId))[i];
+				G4int iPmtCount = pPmtSD->GetPmtCounts()[iPmtNb];
+				m_pEventData->m_pPmtCount->push_back(iPmtCount);
+
+				if(iPmtNb < iNbTopPmts)
+					m_pEventData->m_iNbTopPmtHits += iPmtCount;
+				else if(iPmtNb < iNbTopPmts+iNbBottomPmts)
+					m_pEventData->m_iNbBottomPmtHits += iPmtCount;
+			}
+		}
+		else if((bPmtHits || bPmtTiming || bPmtArea) && pPmtSD) {
+			m_pEventData->m_pPmtHits->resize(iNbTopPmts+iNbBottomPmts+iNbTopVetoPmts+iNbBottomVetoPmts, 0);
+
+			// Pmt hits
+			const vector<G4int> &hHitPmts = pPmtSD->GetHitPmts();
+			for(size_t i=0; i<hHitPmts.size(); i++)
+				(*(m_pEventData->m_pPmtHits))[hHitPmts[i]] = pPmtSD->GetPmtCounts()[hHitPmts[i]];
+
+			m_pEventData->m_iNbTopPmtHits =	accumulate(m_pEventData->m_pPmtHits->begin(), m_pEventData->m_pPmtHits->begin()+iNbTopPmts, 0);
+			m_pEventData->m_iNbBottomPmtHits = accumulate(m_pEventData->m_pPmtHits->begin()+iNbTopPmts, m_pEventData->m_pPmtHits->begin()+iNbTopPmts+iNbBottomPmts, 0);
+		}
+
+		// one row per pmt of pmthits or pmtid
+		if(bPmtTiming && pPmtSD) {
+			G4int iNbTimeBins = muensterTPCPmtSensitiveDetector::GetNbTimeBins();
+			G4int iNbRows = (m_bSparsePmtHits)?(m_pEventData->m_pPmtId->size()):(m_pEventData->m_pPmtHits->size());
+			m_pEventData->m_pPmtTiming->reserve(iNbRows*(1+iNbTimeBins));
 
-		// Pmt hits
-		for(G4int i=0; i<iNbPmtHits; i++)
-			(*(m_pEventData->m_pPmtHits))[(*pPmtHitsCollection)[i]->GetPmtNb()]++;
+			for(G4int i=0; i<iNbRows; i++) {
+				G4int iPmtNb = (m_bSparsePmtHits)?((*(m_pEventData->m_pPmtId))[i]):(i);
+
+				if(iPmtNb < (G4int) pPmtSD->GetPmtCounts().size() && pPmtSD->GetPmtCounts()[iPmtNb] > 0) {
+					m_pEventData->m_pPmtTiming->push_back(pPmtSD->GetFirstTime(iPmtNb)/ns);
+					// 0 bins: only the first time
+					if(iNbTimeBins > 0) {
+						const G4int *pTimeHistogram = pPmtSD->GetTimeHistogram(iPmtNb);
+						m_pEventData->m_pPmtTiming->insert(m_pEventData->m_pPmtTiming->end(), pTimeHistogram, pTimeHistogram+iNbTimeBins);
+					}
+				}
+				else {
+					m_pEventData->m_pPmtTiming->push_back(-1.);
+					m_pEventData->m_pPmtTiming->insert(m_pEventData->m_pPmtTiming->end(), iNbTimeBins, 0.);
+				}
+			}
+		}
+
+		// pulse areas (rows of pmthits or pmtid) or zero suppressed waveforms
+		if(m_bDigitizePmtHits)
+			m_pPmtDigitizer->Digitize(pPmtHitsCollection, (m_bSparsePmtHits)?(m_pEventData->m_pPmtId):(0), m_pEventData);
 
-		m_pEventData->m_iNbTopPmtHits =	accumulate(m_pEventData->m_pPmtHits->begin(), m_pEventData->m_pPmtHits->begin()+iNbTopPmts, 0);
-		m_pEventData->m_iNbBottomPmtHits = accumulate(m_pEventData->m_pPmtHits->begin()+iNbTopPmts, m_pEventData->m_pPmtHits->begin()+iNbTopPmts+iNbBottomPmts, 0);
 		// m_pEventData->m_iNbTopVetoPmtHits = accumulate(m_pEventData->m_pPmtHits->begin()+iNbTopPmts+iNbBottomPmts, m_pEventData->m_pPmtHits->begin()+iNbTopPmts+iNbBottomPmts+iNbTopVetoPmts, 0);
 		// m_pEventData->m_iNbBottomVetoPmtHits =	accumulate(m_pEventData->m_pPmtHits->begin()+iNbTopPmts+iNbBottomPmts+iNbTopVetoPmts, m_pEventData->m_pPmtHits->end(), 0);
 
-		//if((fTotalEnergyDeposited > 0. || iNbPmtHits > 0) && !FilterEvent(m_pEventData))
+		StopCollectTimer();
 		
 	    // save only energy depositing events
-	    if(writeEmptyEvents) {
-			m_pTree->Fill(); // write all events to the tree
-	    } else {
-		    if(fTotalEnergyDeposited > 0. || iNbPmtHits > 0) m_pTree->Fill(); // only events with some activity are written to the tree
+	    if(writeEmptyEvents || fTotalEnergyDeposited > 0. || iNbPmtHits > 0) {
+			// write all events or only events with some activity to the tree
+			if(m_pOutputWriter)
+				m_pOutputWriter->Push(m_pEventData);
+			else
+				FillTree();
 	    }
 
-		// auto save functionality to avoid data loss/ROOT can recover aborted simulations
-		if ( pEvent->GetEventID() % 10000 == 0)
-			m_pTree->AutoSave();
-
 		m_pEventData->Clear();
 	}
+	else
+		StopCollectTimer();
+}
+
+//******************************************************************/
+// every return of EndOfEvent adds the time spent collecting the event
+//******************************************************************/
+void muensterTPCAnalysisManager::StopCollectTimer() {
+	m_hCollectTimer.Stop();
+	m_dCollectTime += m_hCollectTimer.GetRealElapsed();
+	m_iNbCollectedEvents++;
 }
 
 //******************************************************************/
@@ -345,30 +911,340 @@ void muensterTPCAnalysisManager::Step(const G4Step *pStep) {
 }
 
 //******************************************************************/
-// Event filer function which can be called above
+// multi-threading: master thread (merges) or worker/sequential (writes)
 //******************************************************************/
-G4bool muensterTPCAnalysisManager::FilterEvent(muensterTPCEventData *pEventData) {
-	G4double dEnergyDepositedSensitiveRegion = 0.;
+G4bool muensterTPCAnalysisManager::IsMergingMaster() {
+	return (G4Threading::IsMultithreadedApplication() && G4Threading::IsMasterThread());
+}
 
-	vector<float> *pX = pEventData->m_pX;
-	vector<float> *pY = pEventData->m_pY;
-	vector<float> *pZ = pEventData->m_pZ;
-	vector<float> *pEnergyDeposited = pEventData->m_pEnergyDeposited;
+//******************************************************************/
+// buffermerger mode: this thread fills an in-memory file handed to the merger
+//******************************************************************/
+G4bool muensterTPCAnalysisManager::IsBufferMergerFile() {
+#ifdef MUENSTERTPC_BUFFERMERGER
+	return (m_pBufferMergerFile.get() != 0);
+#else
+	return false;
+#endif
+}
 
-	const G4double dDriftLength = muensterTPCDetectorConstruction::GetGeometryParameter("DriftLength");
-	const G4double dRadius = muensterTPCDetectorConstruction::GetGeometryParameter("TeflonCylinderInnerRadius");
+//******************************************************************/
+// compression of the output file, e.g. ZLIB 1 (ROOT default), LZMA 9, LZ4 4, ZSTD 5
+//******************************************************************/
+void muensterTPCAnalysisManager::SetCompression(const G4String &hAlgorithm, G4int iLevel) {
+	G4int iAlgorithm = 1;
+	if(hAlgorithm == "LZMA")
+		iAlgorithm = 2;
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,8,0)
+	else if(hAlgorithm == "LZ4")
+		iAlgorithm = 4;
+#endif
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+	else if(hAlgorithm == "ZSTD")
+		iAlgorithm = 5;
+#endif
+	else if(hAlgorithm != "ZLIB")
+		G4cout << "!!!!> " << hAlgorithm << " is not supported by this ROOT version, using ZLIB!" << G4endl;
+
+	m_iCompressionSettings = 100*iAlgorithm + iLevel;
+}
+
+//******************************************************************/
+// branches of the events tree
+//******************************************************************/
+const vector<G4String> &muensterTPCAnalysisManager::GetBranchNames() {
+	static const char *pBranchNames[] = {"eventid", "seed0", "seed1", "postponed", "ntpmthits", "nbpmthits", "pmthits", "pmttiming",
+		"pmtarea", "wfpmt", "wfstart", "wflength", "wfdata", "etot", "nsteps",
+		"trackid", "type", "parentid", "parenttype", "creaproc", "edproc", "xp", "yp", "zp", "ed", "time",
+		"nclusters", "trackidc", "typec", "xc", "yc", "zc", "edc", "timec", "nstepsc",
+		"type_pri", "e_pri", "xp_pri", "yp_pri", "zp_pri"};
+	static const vector<G4String> hBranchNames(pBranchNames, pBranchNames+sizeof(pBranchNames)/sizeof(pBranchNames[0]));
+
+	return hBranchNames;
+}
+
+//******************************************************************/
+// branch profiles: full, pmt (light collection), deposits (energy
+// depositions), minimal (pmthits and primary position)
+//******************************************************************/
+void muensterTPCAnalysisManager::SetProfile(const G4String &hProfile) {
+	static const char *pPmtBranches[] = {"eventid", "seed0", "seed1", "postponed", "ntpmthits", "nbpmthits", "pmthits", "pmttiming",
+		"pmtarea", "wfpmt", "wfstart", "wflength", "wfdata",
+		"type_pri", "e_pri", "xp_pri", "yp_pri", "zp_pri"};
+	static const char *pDepositsBranches[] = {"eventid", "seed0", "seed1", "postponed", "etot", "nsteps",
+		"trackid", "type", "parentid", "parenttype", "creaproc", "edproc", "xp", "yp", "zp", "ed", "time",
+		"nclusters", "trackidc", "typec", "xc", "yc", "zc", "edc", "timec", "nstepsc",
+		"type_pri", "e_pri", "xp_pri", "yp_pri", "zp_pri"};
+	static const char *pMinimalBranches[] = {"eventid", "pmthits", "xp_pri", "yp_pri", "zp_pri"};
+
+	m_hEnabledBranches.clear();
+
+	if(hProfile == "pmt")
+		m_hEnabledBranches.insert(pPmtBranches, pPmtBranches+sizeof(pPmtBranches)/sizeof(pPmtBranches[0]));
+	else if(hProfile == "deposits")
+		m_hEnabledBranches.insert(pDepositsBranches, pDepositsBranches+sizeof(pDepositsBranches)/sizeof(pDepositsBranches[0]));
+	else if(hProfile == "minimal")
+		m_hEnabledBranches.insert(pMinimalBranches, pMinimalBranches+sizeof(pMinimalBranches)/sizeof(pMinimalBranches[0]));
+	else
+		m_hEnabledBranches.insert(GetBranchNames().begin(), GetBranchNames().end());
+}
+
+//******************************************************************/
+// the enabled branches of this run, with clustering the cluster
+// branches replace the step branches, pmttiming needs the pmt time
+// histograms and the digitizer branches the digitizer mode
+//******************************************************************/
+void muensterTPCAnalysisManager::SelectRunBranches() {
+	static const char *pStepBranches[] = {"trackid", "type", "parentid", "parenttype", "creaproc", "edproc", "xp", "yp", "zp", "ed", "time"};
+	static const char *pClusterBranches[] = {"nclusters", "trackidc", "typec", "xc", "yc", "zc", "edc", "timec", "nstepsc"};
+
+	m_hRunBranches = m_hEnabledBranches;
+
+	if(muensterTPCLXeSensitiveDetector::IsClustering()) {
+		for(size_t i=0; i<sizeof(pStepBranches)/sizeof(pStepBranches[0]); i++)
+			m_hRunBranches.erase(pStepBranches[i]);
+	} else {
+		for(size_t i=0; i<sizeof(pClusterBranches)/sizeof(pClusterBranches[0]); i++)
+			m_hRunBranches.erase(pClusterBranches[i]);
+	}
+
+	if(!muensterTPCPmtSensitiveDetector::IsTimeHistogramming())
+		m_hRunBranches.erase("pmttiming");
+
+	if(!m_bDigitizePmtHits || m_pPmtDigitizer->GetMode() != "area")
+		m_hRunBranches.erase("pmtarea");
+
+	if(!m_bDigitizePmtHits || m_pPmtDigitizer->GetMode() != "zle") {
+		m_hRunBranches.erase("wfpmt");
+		m_hRunBranches.erase("wfstart");
+		m_hRunBranches.erase("wflength");
+		m_hRunBranches.erase("wfdata");
+	}
+}
+
+//******************************************************************/
+// auto save interval: events, bytes (B, kB, MB, GB) or seconds (s, min)
+//******************************************************************/
+void muensterTPCAnalysisManager::SetAutoSave(G4double dAutoSave, const G4String &hAutoSaveUnit) {
+	m_dAutoSave = dAutoSave;
+	m_hAutoSaveUnit = hAutoSaveUnit;
+
+	if(hAutoSaveUnit == "B" || hAutoSaveUnit == "kB" || hAutoSaveUnit == "MB" || hAutoSaveUnit == "GB") {
+		if(hAutoSaveUnit == "kB") m_dAutoSave *= 1e3;
+		if(hAutoSaveUnit == "MB") m_dAutoSave *= 1e6;
+		if(hAutoSaveUnit == "GB") m_dAutoSave *= 1e9;
+		m_hAutoSaveUnit = "bytes";
+	}
+	else if(hAutoSaveUnit == "s" || hAutoSaveUnit == "min") {
+		if(hAutoSaveUnit == "min") m_dAutoSave *= 60.;
+		m_hAutoSaveUnit = "seconds";
+	}
+	else
+		m_hAutoSaveUnit = "events";
+}
+
+//******************************************************************/
+// sensitive detector of this thread, 0 in the master of a multi-threaded run
+//******************************************************************/
+muensterTPCLXeSensitiveDetector *muensterTPCAnalysisManager::GetLXeSensitiveDetector() {
+	// the master builds its own sensitive detectors, the events are only seen by the workers
+	if(IsMergingMaster())
+		return 0;
+
+	return dynamic_cast<muensterTPCLXeSensitiveDetector *>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("muensterTPC/LXeSD", false));
+}
+
+//******************************************************************/
+// pmt sensitive detector of this thread, 0 in the master of a multi-threaded run
+//******************************************************************/
+muensterTPCPmtSensitiveDetector *muensterTPCAnalysisManager::GetPmtSensitiveDetector() {
+	// the master builds its own sensitive detectors, the events are only seen by the workers
+	if(IsMergingMaster())
+		return 0;
+
+	return dynamic_cast<muensterTPCPmtSensitiveDetector *>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("muensterTPC/PmtSD", false));
+}
+
+//******************************************************************/
+// stepping action of this thread, 0 in the master of a multi-threaded run
+//******************************************************************/
+muensterTPCSteppingAction *muensterTPCAnalysisManager::GetSteppingAction() {
+	if(IsMergingMaster())
+		return 0;
+
+	return dynamic_cast<muensterTPCSteppingAction *>(const_cast<G4UserSteppingAction *>(G4RunManager::GetRunManager()->GetUserSteppingAction()));
+}
+
+//******************************************************************/
+// stacking action of this thread, 0 in the master of a multi-threaded run
+//******************************************************************/
+muensterTPCStackingAction *muensterTPCAnalysisManager::GetStackingAction() {
+	if(IsMergingMaster())
+		return 0;
+
+	return dynamic_cast<muensterTPCStackingAction *>(const_cast<G4UserStackingAction *>(G4RunManager::GetRunManager()->GetUserStackingAction()));
+}
+
+//******************************************************************/
+// number of pmts (top, bottom and veto)
+//******************************************************************/
+G4int muensterTPCAnalysisManager::GetNbPmts() {
+	return (G4int) (muensterTPCDetectorConstruction::GetGeometryParameter("NbTopPmts")
+		+ muensterTPCDetectorConstruction::GetGeometryParameter("NbBottomPmts")
+		+ muensterTPCDetectorConstruction::GetGeometryParameter("NbTopVetoPmts")
+		+ muensterTPCDetectorConstruction::GetGeometryParameter("NbBottomVetoPmts"));
+}
+
+//******************************************************************/
+// fill the tree with m_pTreeEventData (simulation or writer thread)
+//******************************************************************/
+void muensterTPCAnalysisManager::FillTree() {
+	m_hWriteTimer.Start();
+
+	m_pTree->Fill();
+
+	// auto save functionality to avoid data loss/ROOT can recover aborted simulations
+	AutoSave();
+
+	m_hWriteTimer.Stop();
+	m_dWriteTime += m_hWriteTimer.GetRealElapsed();
+}
+
+//******************************************************************/
+// auto save the tree (buffermerger mode: send the buffer to the merger)
+//******************************************************************/
+void muensterTPCAnalysisManager::AutoSave() {
+	G4bool bAutoSave = false;
+
+	// events: counted per file, the event ids are shared by all threads
+	if(m_hAutoSaveUnit == "events")
+		bAutoSave = (++m_iNbEventsSinceAutoSave >= m_dAutoSave);
+	else if(m_hAutoSaveUnit == "seconds")
+		bAutoSave = (difftime(time(0), m_hLastAutoSaveTime) >= m_dAutoSave);
+	else if(IsBufferMergerFile())
+		// bytes: ROOT does it for normal files (see BeginOfRun)
+		bAutoSave = (m_pTree->GetZipBytes() >= m_dAutoSave);
 
-	for(G4int i=0; i<pEnergyDeposited->size(); i++)
+	if(!bAutoSave)
+		return;
+
+#ifdef MUENSTERTPC_BUFFERMERGER
+	// m_pTree->Fill() itself only writes to memory and does not need a lock
+	if(IsBufferMergerFile())
+		m_pBufferMergerFile->Write();
+	else
+#endif
+		m_pTree->AutoSave();
+
+	m_iNbEventsSinceAutoSave = 0;
+	m_hLastAutoSaveTime = time(0);
+}
+
+//******************************************************************/
+// write throughput and file size of this thread/process
+//******************************************************************/
+void muensterTPCAnalysisManager::PrintOutputStatistics() {
+	G4double dTotalMBytes = m_pTree->GetTotBytes()/1e6;
+	G4double dZipMBytes = m_pTree->GetZipBytes()/1e6;
+
+	G4cout << "Output " << m_hDataFilename << ": " << m_pTree->GetEntries() << " entries, "
+		<< "compression " << m_pTreeFile->GetCompressionSettings() << ", "
+		<< dTotalMBytes << " MB (" << dZipMBytes << " MB compressed), "
+		<< "write time " << m_dWriteTime << " s";
+	if(m_dWriteTime > 0.)
+		G4cout << " (" << dTotalMBytes/m_dWriteTime << " MB/s)";
+	G4cout << ", collect time " << m_dCollectTime << " s";
+	if(m_iNbCollectedEvents > 0)
+		G4cout << " (" << 1e6*m_dCollectTime/m_iNbCollectedEvents << " us/event)";
+	G4cout << G4endl;
+}
+
+//******************************************************************/
+// datafile name of a worker thread/process: <name>_t<threadid>.root or <name>_p<processid>.root
+//******************************************************************/
+G4String muensterTPCAnalysisManager::GetWorkerDataFilename(const G4String &hFilename, G4int iWorkerId, const G4String &hWorkerTag) {
+	std::stringstream hStream;
+	size_t found = hFilename.rfind(".root");
+	if(found != std::string::npos)
+		hStream << hFilename.substr(0, found) << hWorkerTag << iWorkerId << hFilename.substr(found);
+	else
+		hStream << hFilename << hWorkerTag << iWorkerId;
+	return hStream.str();
+}
+
+//******************************************************************/
+// merge the datafiles of all worker threads and remove them afterwards
+//******************************************************************/
+void muensterTPCAnalysisManager::MergeWorkerDataFiles() {
+#ifdef G4MULTITHREADED
+	G4int iNbThreads = G4MTRunManager::GetMasterRunManager()->GetNumberOfThreads();
+
+	vector<G4String> hWorkerFilenames;
+	for(G4int iThreadId=0; iThreadId<iNbThreads; iThreadId++)
 	{
-		if((*pZ)[i] < 0. && (*pZ)[i] > -dDriftLength && std::sqrt((*pX)[i]*(*pX)[i] + (*pY)[i]*(*pY)[i]) < dRadius)
-			dEnergyDepositedSensitiveRegion += (*pEnergyDeposited)[i];
+		G4String hWorkerFilename = GetWorkerDataFilename(m_hDataFilename, iThreadId);
+		if(std::ifstream(hWorkerFilename.c_str()).good())
+			hWorkerFilenames.push_back(hWorkerFilename);
 	}
 
-//if(dEnergyDepositedSensitiveRegion > 0. && dEnergyDepositedSensitiveRegion < 100.)
-	if(dEnergyDepositedSensitiveRegion > 0.)
-		return false;
+	G4cout << "Merging " << hWorkerFilenames.size() << " worker datafiles into " << m_hDataFilename << G4endl;
+
+	if(MergeDataFiles(hWorkerFilenames, m_hDataFilename, m_iCompressionSettings))
+	{
+		for(size_t i=0; i<hWorkerFilenames.size(); i++)
+			std::remove(hWorkerFilenames[i].c_str());
+	}
 	else
-		return true;
+		G4cout << "!!!!> Merging failed, the worker datafiles are kept!" << G4endl;
+#endif
 }
 
+//******************************************************************/
+// merge datafiles, the events trees are chained and 'nbevents' is summed up
+//******************************************************************/
+G4bool muensterTPCAnalysisManager::MergeDataFiles(const vector<G4String> &hInputFilenames, const G4String &hOutputFilename, G4int iCompressionSettings) {
+	if(hInputFilenames.empty())
+		return false;
+
+	// the baskets are copied without recompression if the settings are the same
+	TFileMerger hFileMerger(kFALSE);
+	hFileMerger.SetPrintLevel(0);
+	if(iCompressionSettings >= 0) {
+		if(!hFileMerger.OutputFile(hOutputFilename.c_str(), "RECREATE", iCompressionSettings))
+			return false;
+	}
+	else if(!hFileMerger.OutputFile(hOutputFilename.c_str(), "RECREATE"))
+		return false;
+
+	for(size_t i=0; i<hInputFilenames.size(); i++)
+		hFileMerger.AddFile(hInputFilenames[i].c_str(), kFALSE);
+
+	// the tags can not be merged, they are written once to the merged file
+	hFileMerger.AddObjectNames("G4VERSION_TAG MC_TAG MCVERSION_TAG");
+	if(!hFileMerger.PartialMerge(TFileMerger::kAll | TFileMerger::kRegular | TFileMerger::kSkipListed))
+		return false;
+
+	TFile *pDataFile = new TFile(hOutputFilename.c_str(), "UPDATE");
+	WriteDataFileTags();
+	// the merged maps are sums, they are computed again from the merged counts
+	muensterTPCLceMap::UpdateMaps(pDataFile);
+	pDataFile->Close();
+	delete pDataFile;
+
+	return true;
+}
+
+//******************************************************************/
+// write the version tags into the current directory
+//******************************************************************/
+void muensterTPCAnalysisManager::WriteDataFileTags() {
+		TNamed G4version("G4VERSION_TAG",G4VERSION_TAG);
+		G4version.Write();
+		TNamed G4MCname("MC_TAG","muensterTPC");
+		G4MCname.Write();
+		TNamed G4MCVersion("MCVERSION_TAG","X.Y.Z");
+		G4MCVersion.Write();
+}
+
+
 	
@@ -0,0 +1,499 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * Communications with the AnalysisManager class (data output)
+ * 
+ * @comment 
+ ******************************************************************/
+
+#include <G4UIdirectory.hh>
+#include <G4UIcmdWithAString.hh>
+#include <G4UIcmdWithAnInteger.hh>
+#include <G4UIcmdWithADouble.hh>
+#include <G4Tokenizer.hh>
+#include <G4ios.hh>
+
+#include "muensterTPCAnalysisMessenger.hh"
+#include "muensterTPCAnalysisManager.hh"
+#include "muensterTPCLceMap.hh"
+#include "muensterTPCPmtDigitizer.hh"
+#include "muensterTPCEventFilter.hh"
+
+muensterTPCAnalysisMessenger::muensterTPCAnalysisMessenger(muensterTPCAnalysisManager *pAnalysisManager):
+  m_pAnalysisManager(pAnalysisManager)
+{
+  // create directory
+  m_pDirectory = new G4UIdirectory("/Xe/output/");
+  m_pDirectory->SetGuidance("Data output control commands.");
+
+  // how the worker threads write their data (multi-threaded mode only)
+  m_pOutputModeCmd = new G4UIcmdWithAString("/Xe/output/mode", this);
+  m_pOutputModeCmd->SetGuidance("Choose how worker threads write the output file:");
+  m_pOutputModeCmd->SetGuidance("<threadfiles = one file per thread, merged after the run>");
+  m_pOutputModeCmd->SetGuidance("<buffermerger = in-memory files, merged into one file while running>");
+  m_pOutputModeCmd->SetParameterName("mode", false);
+  m_pOutputModeCmd->SetCandidates("threadfiles buffermerger");
+  m_pOutputModeCmd->SetDefaultValue("threadfiles");
+  m_pOutputModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // particle and process names as strings or integer codes
+  m_pEncodingCmd = new G4UIcmdWithAString("/Xe/output/encoding", this);
+  m_pEncodingCmd->SetGuidance("Choose how particle and process names are stored:");
+  m_pEncodingCmd->SetGuidance("<string = names (vector<string>)>");
+  m_pEncodingCmd->SetGuidance("<code = PDG codes and process ids (vector<int>) with the dictionaries events/typedict and events/procdict>");
+  m_pEncodingCmd->SetParameterName("encoding", false);
+  m_pEncodingCmd->SetCandidates("string code");
+  m_pEncodingCmd->SetDefaultValue("string");
+  m_pEncodingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // dense or sparse pmt hits
+  m_pPmtHitsCmd = new G4UIcmdWithAString("/Xe/output/pmtHits", this);
+  m_pPmtHitsCmd->SetGuidance("Choose how the hits per PMT are stored:");
+  m_pPmtHitsCmd->SetGuidance("<dense = number of hits of every PMT (pmthits)>");
+  m_pPmtHitsCmd->SetGuidance("<sparse = PMTs with hits and their number of hits (pmtid, pmtcount)>");
+  m_pPmtHitsCmd->SetParameterName("encoding", false);
+  m_pPmtHitsCmd->SetCandidates("dense sparse");
+  m_pPmtHitsCmd->SetDefaultValue("dense");
+  m_pPmtHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  G4UIparameter *pParameter;
+
+  // compression algorithm and level of the output file
+  m_pCompressionCmd = new G4UIcommand("/Xe/output/compression", this);
+  m_pCompressionCmd->SetGuidance("Set the compression algorithm and level (0 = no compression) of the output file.");
+  m_pCompressionCmd->SetGuidance("LZ4 needs ROOT >= 6.08, ZSTD needs ROOT >= 6.20.");
+  m_pCompressionCmd->SetGuidance("[usage] /Xe/output/compression ZLIB 1");
+  pParameter = new G4UIparameter("algorithm", 's', false);
+  pParameter->SetParameterCandidates("ZLIB LZMA LZ4 ZSTD");
+  m_pCompressionCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("level", 'i', true);
+  pParameter->SetDefaultValue(1);
+  pParameter->SetParameterRange("level >= 0 && level <= 9");
+  m_pCompressionCmd->SetParameter(pParameter);
+  m_pCompressionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // basket size of all or of single branches
+  m_pBasketSizeCmd = new G4UIcommand("/Xe/output/basketSize", this);
+  m_pBasketSizeCmd->SetGuidance("Set the basket size (bytes) of the branches of the events tree.");
+  m_pBasketSizeCmd->SetGuidance("The branch name can contain wildcards, * = all branches (default).");
+  m_pBasketSizeCmd->SetGuidance("[usage] /Xe/output/basketSize 256000 ed");
+  pParameter = new G4UIparameter("size", 'i', false);
+  pParameter->SetParameterRange("size > 0");
+  m_pBasketSizeCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("branch", 's', true);
+  pParameter->SetDefaultValue("*");
+  m_pBasketSizeCmd->SetParameter(pParameter);
+  m_pBasketSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // auto save interval of the events tree
+  m_pAutoSaveCmd = new G4UIcommand("/Xe/output/autoSave", this);
+  m_pAutoSaveCmd->SetGuidance("Set the auto save interval of the events tree in events, bytes or time.");
+  m_pAutoSaveCmd->SetGuidance("[usage] /Xe/output/autoSave 10000 events | 300 MB | 10 min");
+  pParameter = new G4UIparameter("interval", 'd', false);
+  pParameter->SetParameterRange("interval > 0.");
+  m_pAutoSaveCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetParameterCandidates("events B kB MB GB s min");
+  pParameter->SetDefaultValue("events");
+  m_pAutoSaveCmd->SetParameter(pParameter);
+  m_pAutoSaveCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // fill the tree in a separate writer thread
+  m_pAsyncWriterCmd = new G4UIcmdWithAnInteger("/Xe/output/asyncWriter", this);
+  m_pAsyncWriterCmd->SetGuidance("Fill the events tree in a writer thread with a queue of this many events.");
+  m_pAsyncWriterCmd->SetGuidance("0 fills the tree at the end of each event (default).");
+  m_pAsyncWriterCmd->SetParameterName("queueSize", false);
+  m_pAsyncWriterCmd->SetRange("queueSize >= 0");
+  m_pAsyncWriterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // branches of the events tree
+  G4String hBranchNames;
+  for(size_t i=0; i<muensterTPCAnalysisManager::GetBranchNames().size(); i++)
+    hBranchNames += muensterTPCAnalysisManager::GetBranchNames()[i] + " ";
+
+  m_pProfileCmd = new G4UIcmdWithAString("/Xe/output/profile", this);
+  m_pProfileCmd->SetGuidance("Choose the branches of the events tree:");
+  m_pProfileCmd->SetGuidance("<full = all branches (default)>");
+  m_pProfileCmd->SetGuidance("<pmt = eventid, seeds, PMT hits and primary particle>");
+  m_pProfileCmd->SetGuidance("<deposits = eventid, seeds, energy depositions and primary particle>");
+  m_pProfileCmd->SetGuidance("<minimal = eventid, pmthits, xp_pri, yp_pri, zp_pri>");
+  m_pProfileCmd->SetGuidance("Single branches can be changed afterwards with enableBranch and disableBranch.");
+  m_pProfileCmd->SetParameterName("profile", false);
+  m_pProfileCmd->SetCandidates("full pmt deposits minimal");
+  m_pProfileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pEnableBranchCmd = new G4UIcmdWithAString("/Xe/output/enableBranch", this);
+  m_pEnableBranchCmd->SetGuidance("Write this branch of the events tree.");
+  m_pEnableBranchCmd->SetParameterName("branch", false);
+  m_pEnableBranchCmd->SetCandidates(hBranchNames);
+  m_pEnableBranchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDisableBranchCmd = new G4UIcmdWithAString("/Xe/output/disableBranch", this);
+  m_pDisableBranchCmd->SetGuidance("Do not write (and gather) this branch of the events tree.");
+  m_pDisableBranchCmd->SetParameterName("branch", false);
+  m_pDisableBranchCmd->SetCandidates(hBranchNames);
+  m_pDisableBranchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // light collection efficiency maps
+  m_pLceMapCmd = new G4UIcommand("/Xe/output/lceMap", this);
+  m_pLceMapCmd->SetGuidance("Accumulate light collection efficiency maps (emission position vs. detected photons per PMT)");
+  m_pLceMapCmd->SetGuidance("in memory instead of writing tree entries. Only the maps are written to the directory lce.");
+  m_pLceMapCmd->SetGuidance("[usage] /Xe/output/lceMap off | rphiz <r bins> <phi bins> <z bins> | xyz <x bins> <y bins> <z bins>");
+  pParameter = new G4UIparameter("coordinates", 's', false);
+  pParameter->SetParameterCandidates("off rphiz xyz");
+  m_pLceMapCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("bins1", 'i', true);
+  pParameter->SetDefaultValue("20");
+  m_pLceMapCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("bins2", 'i', true);
+  pParameter->SetDefaultValue("36");
+  m_pLceMapCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("bins3", 'i', true);
+  pParameter->SetDefaultValue("34");
+  m_pLceMapCmd->SetParameter(pParameter);
+  m_pLceMapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pLceMapRangeCmd = new G4UIcommand("/Xe/output/lceMapRange", this);
+  m_pLceMapRangeCmd->SetGuidance("Set the range of the light collection efficiency maps (mm, phi in deg).");
+  m_pLceMapRangeCmd->SetGuidance("Default: the active volume, r 0 40 phi -180 180 z -169 -2");
+  m_pLceMapRangeCmd->SetGuidance("[usage] /Xe/output/lceMapRange <min1> <max1> <min2> <max2> <min3> <max3>");
+  const char *szRangeNames[] = {"min1", "max1", "min2", "max2", "min3", "max3"};
+  for(G4int i=0; i<6; i++)
+  {
+    pParameter = new G4UIparameter(szRangeNames[i], 'd', false);
+    m_pLceMapRangeCmd->SetParameter(pParameter);
+  }
+  m_pLceMapRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // pmt waveforms from the photon hit times (needs /Xe/detector/setPmtHits full)
+  m_pDigitizerDirectory = new G4UIdirectory("/Xe/output/digitizer/");
+  m_pDigitizerDirectory->SetGuidance("Digitized pmt waveforms, in photoelectrons per sample (needs /Xe/detector/setPmtHits full).");
+
+  m_pDigitizerModeCmd = new G4UIcmdWithAString("/Xe/output/digitizer/mode", this);
+  m_pDigitizerModeCmd->SetGuidance("off: no digitizer (default)");
+  m_pDigitizerModeCmd->SetGuidance("area: pulse area of the waveform per pmt (pmtarea)");
+  m_pDigitizerModeCmd->SetGuidance("zle: zero suppressed waveforms (wfpmt, wfstart, wflength, wfdata)");
+  m_pDigitizerModeCmd->SetParameterName("mode", false);
+  m_pDigitizerModeCmd->SetCandidates("off area zle");
+  m_pDigitizerModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerSamplingCmd = new G4UIcommand("/Xe/output/digitizer/sampling", this);
+  m_pDigitizerSamplingCmd->SetGuidance("Sampling period (default 10 ns).");
+  m_pDigitizerSamplingCmd->SetGuidance("[usage] /Xe/output/digitizer/sampling 10 ns");
+  pParameter = new G4UIparameter("period", 'd', false);
+  pParameter->SetParameterRange("period > 0.");
+  m_pDigitizerSamplingCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetDefaultValue("ns");
+  m_pDigitizerSamplingCmd->SetParameter(pParameter);
+  m_pDigitizerSamplingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerWindowCmd = new G4UIcommand("/Xe/output/digitizer/window", this);
+  m_pDigitizerWindowCmd->SetGuidance("Start (global time) and length of the digitized window (default -100 ns, 1000 ns).");
+  m_pDigitizerWindowCmd->SetGuidance("[usage] /Xe/output/digitizer/window -100 1000 ns");
+  pParameter = new G4UIparameter("start", 'd', false);
+  m_pDigitizerWindowCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("length", 'd', false);
+  pParameter->SetParameterRange("length > 0.");
+  m_pDigitizerWindowCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetDefaultValue("ns");
+  m_pDigitizerWindowCmd->SetParameter(pParameter);
+  m_pDigitizerWindowCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerSpeShapeCmd = new G4UIcommand("/Xe/output/digitizer/speShape", this);
+  m_pDigitizerSpeShapeCmd->SetGuidance("Single photoelectron pulse exp(-t/fall)-exp(-t/rise) (default 3 ns, 10 ns).");
+  m_pDigitizerSpeShapeCmd->SetGuidance("[usage] /Xe/output/digitizer/speShape 3 10 ns");
+  pParameter = new G4UIparameter("rise", 'd', false);
+  pParameter->SetParameterRange("rise >= 0.");
+  m_pDigitizerSpeShapeCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("fall", 'd', false);
+  pParameter->SetParameterRange("fall > 0.");
+  m_pDigitizerSpeShapeCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetDefaultValue("ns");
+  m_pDigitizerSpeShapeCmd->SetParameter(pParameter);
+  m_pDigitizerSpeShapeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerSpeTemplateCmd = new G4UIcmdWithAString("/Xe/output/digitizer/speTemplate", this);
+  m_pDigitizerSpeTemplateCmd->SetGuidance("Single photoelectron pulse from a text file, one value per sample (sampling period).");
+  m_pDigitizerSpeTemplateCmd->SetGuidance("The pulse is normalized to the area 1, lines starting with # are skipped.");
+  m_pDigitizerSpeTemplateCmd->SetParameterName("file", false);
+  m_pDigitizerSpeTemplateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerGainSpreadCmd = new G4UIcmdWithADouble("/Xe/output/digitizer/gainSpread", this);
+  m_pDigitizerGainSpreadCmd->SetGuidance("Relative width of the single photoelectron area (gaussian, default 0.3).");
+  m_pDigitizerGainSpreadCmd->SetParameterName("spread", false);
+  m_pDigitizerGainSpreadCmd->SetRange("spread >= 0.");
+  m_pDigitizerGainSpreadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerNoiseCmd = new G4UIcmdWithADouble("/Xe/output/digitizer/noise", this);
+  m_pDigitizerNoiseCmd->SetGuidance("Gaussian baseline noise per sample of the hit pmts [pe/sample] (default 0).");
+  m_pDigitizerNoiseCmd->SetParameterName("sigma", false);
+  m_pDigitizerNoiseCmd->SetRange("sigma >= 0.");
+  m_pDigitizerNoiseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pDigitizerZleCmd = new G4UIcommand("/Xe/output/digitizer/zle", this);
+  m_pDigitizerZleCmd->SetGuidance("Zero suppression: threshold [pe/sample] and samples stored before and after (default 0.05 5 5).");
+  m_pDigitizerZleCmd->SetGuidance("[usage] /Xe/output/digitizer/zle 0.05 5 5");
+  pParameter = new G4UIparameter("threshold", 'd', false);
+  m_pDigitizerZleCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("pre", 'i', true);
+  pParameter->SetParameterRange("pre >= 0");
+  pParameter->SetDefaultValue("5");
+  m_pDigitizerZleCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("post", 'i', true);
+  pParameter->SetParameterRange("post >= 0");
+  pParameter->SetDefaultValue("5");
+  m_pDigitizerZleCmd->SetParameter(pParameter);
+  m_pDigitizerZleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // events failing one of the filters are not written
+  m_pFilterDirectory = new G4UIdirectory("/Xe/output/filter/");
+  m_pFilterDirectory->SetGuidance("Event filters applied before the event data is gathered (default: all events are written).");
+
+  m_pFilterPrimaryTypeCmd = new G4UIcmdWithAString("/Xe/output/filter/primaryType", this);
+  m_pFilterPrimaryTypeCmd->SetGuidance("Only events of these primary particles (separated by commas), all: no filter.");
+  m_pFilterPrimaryTypeCmd->SetGuidance("[usage] /Xe/output/filter/primaryType gamma,e-");
+  m_pFilterPrimaryTypeCmd->SetParameterName("types", false);
+  m_pFilterPrimaryTypeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pFilterPmtHitsCmd = new G4UIcommand("/Xe/output/filter/pmtHits", this);
+  m_pFilterPmtHitsCmd->SetGuidance("Minimum number of photons detected by the top and by the bottom pmts, 0 0: no filter.");
+  m_pFilterPmtHitsCmd->SetGuidance("[usage] /Xe/output/filter/pmtHits 1 3");
+  pParameter = new G4UIparameter("top", 'i', false);
+  pParameter->SetParameterRange("top >= 0");
+  m_pFilterPmtHitsCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("bottom", 'i', false);
+  pParameter->SetParameterRange("bottom >= 0");
+  m_pFilterPmtHitsCmd->SetParameter(pParameter);
+  m_pFilterPmtHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pFilterEnergyCmd = new G4UIcommand("/Xe/output/filter/energy", this);
+  m_pFilterEnergyCmd->SetGuidance("Range [min, max) of the total energy deposit (etot), max <= min: no filter.");
+  m_pFilterEnergyCmd->SetGuidance("[usage] /Xe/output/filter/energy 1 100 keV");
+  pParameter = new G4UIparameter("min", 'd', false);
+  m_pFilterEnergyCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("max", 'd', false);
+  m_pFilterEnergyCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetDefaultValue("keV");
+  m_pFilterEnergyCmd->SetParameter(pParameter);
+  m_pFilterEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pFilterFiducialEnergyCmd = new G4UIcommand("/Xe/output/filter/fiducialEnergy", this);
+  m_pFilterFiducialEnergyCmd->SetGuidance("Range [min, max) of the energy deposit in the fiducial volume, max <= min: no filter.");
+  m_pFilterFiducialEnergyCmd->SetGuidance("[usage] /Xe/output/filter/fiducialEnergy 1 100 keV");
+  pParameter = new G4UIparameter("min", 'd', false);
+  m_pFilterFiducialEnergyCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("max", 'd', false);
+  m_pFilterFiducialEnergyCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetDefaultValue("keV");
+  m_pFilterFiducialEnergyCmd->SetParameter(pParameter);
+  m_pFilterFiducialEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pFilterFiducialVolumeCmd = new G4UIcommand("/Xe/output/filter/fiducialVolume", this);
+  m_pFilterFiducialVolumeCmd->SetGuidance("Cylinder r < rmax, zmin < z < zmax of the fiducial energy filter.");
+  m_pFilterFiducialVolumeCmd->SetGuidance("Default: the drift region inside the teflon cylinder.");
+  m_pFilterFiducialVolumeCmd->SetGuidance("[usage] /Xe/output/filter/fiducialVolume 30 -70 -10 mm");
+  pParameter = new G4UIparameter("rmax", 'd', false);
+  pParameter->SetParameterRange("rmax > 0.");
+  m_pFilterFiducialVolumeCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("zmin", 'd', false);
+  m_pFilterFiducialVolumeCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("zmax", 'd', false);
+  m_pFilterFiducialVolumeCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("unit", 's', true);
+  pParameter->SetDefaultValue("mm");
+  m_pFilterFiducialVolumeCmd->SetParameter(pParameter);
+  m_pFilterFiducialVolumeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  m_pFilterResetCmd = new G4UIcommand("/Xe/output/filter/reset", this);
+  m_pFilterResetCmd->SetGuidance("Switch off all event filters.");
+  m_pFilterResetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+muensterTPCAnalysisMessenger::~muensterTPCAnalysisMessenger()
+{
+  delete m_pOutputModeCmd;
+  delete m_pEncodingCmd;
+  delete m_pPmtHitsCmd;
+  delete m_pCompressionCmd;
+  delete m_pBasketSizeCmd;
+  delete m_pAutoSaveCmd;
+  delete m_pAsyncWriterCmd;
+  delete m_pProfileCmd;
+  delete m_pEnableBranchCmd;
+  delete m_pDisableBranchCmd;
+  delete m_pLceMapCmd;
+  delete m_pLceMapRangeCmd;
+  delete m_pDigitizerModeCmd;
+  delete m_pDigitizerSamplingCmd;
+  delete m_pDigitizerWindowCmd;
+  delete m_pDigitizerSpeShapeCmd;
+  delete m_pDigitizerSpeTemplateCmd;
+  delete m_pDigitizerGainSpreadCmd;
+  delete m_pDigitizerNoiseCmd;
+  delete m_pDigitizerZleCmd;
+  delete m_pDigitizerDirectory;
+  delete m_pFilterPrimaryTypeCmd;
+  delete m_pFilterPmtHitsCmd;
+  delete m_pFilterEnergyCmd;
+  delete m_pFilterFiducialEnergyCmd;
+  delete m_pFilterFiducialVolumeCmd;
+  delete m_pFilterResetCmd;
+  delete m_pFilterDirectory;
+  delete m_pDirectory;
+}
+
+void
+muensterTPCAnalysisMessenger::SetNewValue(G4UIcommand * command, G4String newValues)
+{
+  if(command == m_pOutputModeCmd)
+    m_pAnalysisManager->SetOutputMode(newValues);
+
+  if(command == m_pEncodingCmd)
+    m_pAnalysisManager->SetEncoding(newValues);
+
+  if(command == m_pPmtHitsCmd)
+    m_pAnalysisManager->SetPmtHitsEncoding(newValues);
+
+  if(command == m_pCompressionCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4String hAlgorithm = next();
+    G4int iLevel = StoI(next());
+    m_pAnalysisManager->SetCompression(hAlgorithm, iLevel);
+  }
+
+  if(command == m_pBasketSizeCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4int iBasketSize = StoI(next());
+    G4String hBranchName = next();
+    m_pAnalysisManager->SetBasketSize(hBranchName, iBasketSize);
+  }
+
+  if(command == m_pAutoSaveCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dAutoSave = StoD(next());
+    G4String hUnit = next();
+    m_pAnalysisManager->SetAutoSave(dAutoSave, hUnit);
+  }
+
+  if(command == m_pAsyncWriterCmd)
+    m_pAnalysisManager->SetAsyncWriter(m_pAsyncWriterCmd->GetNewIntValue(newValues));
+
+  if(command == m_pProfileCmd)
+    m_pAnalysisManager->SetProfile(newValues);
+
+  if(command == m_pEnableBranchCmd)
+    m_pAnalysisManager->EnableBranch(newValues);
+
+  if(command == m_pDisableBranchCmd)
+    m_pAnalysisManager->DisableBranch(newValues);
+
+  if(command == m_pLceMapCmd)
+  {
+    G4Tokenizer next(newValues);
+    m_pAnalysisManager->GetLceMap()->SetCoordinates(next());
+    G4int iNbBins1 = StoI(next());
+    G4int iNbBins2 = StoI(next());
+    G4int iNbBins3 = StoI(next());
+    m_pAnalysisManager->GetLceMap()->SetBins(iNbBins1, iNbBins2, iNbBins3);
+  }
+
+  if(command == m_pLceMapRangeCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dRange[6];
+    for(G4int i=0; i<6; i++)
+      dRange[i] = StoD(next());
+    m_pAnalysisManager->GetLceMap()->SetRange(dRange[0], dRange[1], dRange[2], dRange[3], dRange[4], dRange[5]);
+  }
+
+  if(command == m_pDigitizerModeCmd)
+    m_pAnalysisManager->GetPmtDigitizer()->SetMode(newValues);
+
+  if(command == m_pDigitizerSamplingCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dPeriod = StoD(next());
+    m_pAnalysisManager->GetPmtDigitizer()->SetSamplingPeriod(dPeriod*G4UIcommand::ValueOf(next()));
+  }
+
+  if(command == m_pDigitizerWindowCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dStart = StoD(next());
+    G4double dLength = StoD(next());
+    G4double dUnit = G4UIcommand::ValueOf(next());
+    m_pAnalysisManager->GetPmtDigitizer()->SetWindow(dStart*dUnit, dLength*dUnit);
+  }
+
+  if(command == m_pDigitizerSpeShapeCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dRiseTime = StoD(next());
+    G4double dFallTime = StoD(next());
+    G4double dUnit = G4UIcommand::ValueOf(next());
+    m_pAnalysisManager->GetPmtDigitizer()->SetSpeShape(dRiseTime*dUnit, dFallTime*dUnit);
+  }
+
+  if(command == m_pDigitizerSpeTemplateCmd)
+    m_pAnalysisManager->GetPmtDigitizer()->SetSpeTemplate(newValues);
+
+  if(command == m_pDigitizerGainSpreadCmd)
+    m_pAnalysisManager->GetPmtDigitizer()->SetGainSpread(m_pDigitizerGainSpreadCmd->GetNewDoubleValue(newValues));
+
+  if(command == m_pDigitizerNoiseCmd)
+    m_pAnalysisManager->GetPmtDigitizer()->SetNoise(m_pDigitizerNoiseCmd->GetNewDoubleValue(newValues));
+
+  if(command == m_pDigitizerZleCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dThreshold = StoD(next());
+    G4int iNbPreSamples = StoI(next());
+    G4int iNbPostSamples = StoI(next());
+    m_pAnalysisManager->GetPmtDigitizer()->SetZeroLengthEncoding(dThreshold, iNbPreSamples, iNbPostSamples);
+  }
+
+  if(command == m_pFilterPrimaryTypeCmd)
+    m_pAnalysisManager->GetEventFilter()->SetPrimaryTypes(newValues);
+
+  if(command == m_pFilterPmtHitsCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4int iMinTopPmtHits = StoI(next());
+    G4int iMinBottomPmtHits = StoI(next());
+    m_pAnalysisManager->GetEventFilter()->SetMinPmtHits(iMinTopPmtHits, iMinBottomPmtHits);
+  }
+
+  if(command == m_pFilterEnergyCmd || command == m_pFilterFiducialEnergyCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dMinEnergy = StoD(next());
+    G4double dMaxEnergy = StoD(next());
+    G4double dUnit = G4UIcommand::ValueOf(next());
+    if(command == m_pFilterEnergyCmd)
+      m_pAnalysisManager->GetEventFilter()->SetEnergyRange(dMinEnergy*dUnit, dMaxEnergy*dUnit);
+    else
+      m_pAnalysisManager->GetEventFilter()->SetFiducialEnergyRange(dMinEnergy*dUnit, dMaxEnergy*dUnit);
+  }
+
+  if(command == m_pFilterFiducialVolumeCmd)
+  {
+    G4Tokenizer next(newValues);
+    G4double dMaxRadius = StoD(next());
+    G4double dMinZ = StoD(next());
+    G4double dMaxZ = StoD(next());
+    G4double dUnit = G4UIcommand::ValueOf(next());
+    m_pAnalysisManager->GetEventFilter()->SetFiducialVolume(dMaxRadius*dUnit, dMinZ*dUnit, dMaxZ*dUnit);
+  }
+
+  if(command == m_pFilterResetCmd)
+    m_pAnalysisManager->GetEventFilter()->Reset();
+}
@@ -27,6 +27,7 @@
 #include <G4SystemOfUnits.hh>
 #include <G4UserLimits.hh>
 #include <G4RunManager.hh>
+#include <G4Region.hh>
 
 // include C++ classes
 #include <globals.hh>
@@ -46,6 +47,7 @@ using std::max;
 #include "muensterTPCPmtSensitiveDetector.hh"
 #include "muensterTPCDetectorConstruction.hh"
 #include "muensterTPCDetectorMessenger.hh"
+#include "muensterTPCOpticalRayTracer.hh"
 
 map<G4String, G4double> muensterTPCDetectorConstruction::m_hGeometryParameters;
 
@@ -84,6 +86,8 @@ muensterTPCDetectorConstruction::muensterTPCDetectorConstruction() {
 
   m_pRotationX0 = new G4RotationMatrix();
   m_pRotationX0->rotateX(0.*deg);
+
+  m_pOpticsRegion = 0;
         
   m_pDetectorMessenger = new muensterTPCDetectorMessenger(this);
 }
@@ -118,6 +122,17 @@ G4VPhysicalVolume* muensterTPCDetectorConstruction::Construct() {
   ConstructFieldCage();
 
   ConstructPmtArrays();
+
+  // drift region in world coordinates (the LXe is placed in the outer cryostat vacuum, the lab at the origin)
+  const G4double dLXeZ = m_pLXePhysicalVolume->GetTranslation().z()+m_pOuterCryostatVacuumPhysicalVolume->GetTranslation().z();
+  m_hGeometryParameters["GateMeshZ"] = dLXeZ+m_hGridMeshPhysicalVolumes[2]->GetTranslation().z();
+  m_hGeometryParameters["CathodeMeshZ"] = dLXeZ+m_hGridMeshPhysicalVolumes[3]->GetTranslation().z();
+
+  // optical photons in the TPC are traced by the model of each thread (see ConstructSDandField)
+  if(muensterTPCOpticalRayTracer::IsEnabled() && !m_pOpticsRegion) {
+    m_pOpticsRegion = new G4Region("muensterTPC/OpticsRegion");
+    m_pOpticsRegion->AddRootLogicalVolume(m_pLXeLogicalVolume);
+  }
   
   //PrintPhysicalVolumes();
 
@@ -126,11 +141,42 @@ G4VPhysicalVolume* muensterTPCDetectorConstruction::Construct() {
 	return m_pLabPhysicalVolume;
 }
 
+//******************************************************************/
+// ConstructSDandField
+//******************************************************************/
+void muensterTPCDetectorConstruction::ConstructSDandField() {
+  // sensitive detectors are thread-local, this is called for every worker thread
+  G4SDManager *pSDManager = G4SDManager::GetSDMpointer();
+
+  //------------------------------ xenon sensitivity ------------------------------
+  muensterTPCLXeSensitiveDetector *pLXeSD = new muensterTPCLXeSensitiveDetector("muensterTPC/LXeSD");
+  pSDManager->AddNewDetector(pLXeSD);
+  SetSensitiveDetector(m_pLXeLogicalVolume, pLXeSD);
+  SetSensitiveDetector(m_pGXeLogicalVolume, pLXeSD);
+
+  //------------------------------- pmt sensitivity -------------------------------
+  muensterTPCPmtSensitiveDetector *pPmtSD = new muensterTPCPmtSensitiveDetector("muensterTPC/PmtSD");
+  pSDManager->AddNewDetector(pPmtSD);
+  SetSensitiveDetector(m_pPmtPhotoCathodeLogicalVolume, pPmtSD);
+
+  //------------------------------ optical ray tracer ------------------------------
+  // the GXe is a daughter of the LXe and belongs to the same region
+  if(m_pOpticsRegion)
+    new muensterTPCOpticalRayTracer("muensterTPC/OpticalRayTracer", m_pOpticsRegion);
+}
+
 //******************************************************************/
 // GetGeometryParameter
 //******************************************************************/
 G4double muensterTPCDetectorConstruction::GetGeometryParameter(const char *szParameter) {
-  return m_hGeometryParameters[szParameter];
+  // read only, the map is shared by all threads
+  map<G4String, G4double>::const_iterator pIt = m_hGeometryParameters.find(szParameter);
+  if(pIt == m_hGeometryParameters.end()) {
+    G4cout << "!!!!> geometry parameter " << szParameter << " is not defined, using 0." << G4endl;
+    return 0.;
+  }
+
+  return pIt->second;
 }
 
 //******************************************************************/
@@ -508,6 +554,10 @@ void muensterTPCDetectorConstruction::DefineGeometryParameters() {
   m_hGeometryParameters["NbBottomPmtsThirdRow"]  = 2;
   m_hGeometryParameters["NbBottomPmts"] = 7;
 
+  // no veto pmts in this detector
+  m_hGeometryParameters["NbTopVetoPmts"] = 0;
+  m_hGeometryParameters["NbBottomVetoPmts"] = 0;
+
   m_hGeometryParameters["SpaceBelowTopPMTHeight"] = 3.05*mm;
 
   // inner cryostat
@@ -988,12 +1038,7 @@ void muensterTPCDetectorConstruction::ConstructXenon() {
 
 
   //------------------------------ xenon sensitivity ------------------------------
-  G4SDManager *pSDManager = G4SDManager::GetSDMpointer();
-
-  muensterTPCLXeSensitiveDetector *pLXeSD = new muensterTPCLXeSensitiveDetector("muensterTPC/LXeSD");
-  pSDManager->AddNewDetector(pLXeSD);
-  m_pLXeLogicalVolume->SetSensitiveDetector(pLXeSD);
-  m_pGXeLogicalVolume->SetSensitiveDetector(pLXeSD);
+  // see ConstructSDandField
 
   //================================== attributes =================================
   G4Colour hLXeColor(0.0,0.0,1.0,DetectorMaterialAlphaChannel); //blue
@@ -1613,12 +1658,7 @@ void muensterTPCDetectorConstruction::ConstructPmtArrays() {
     }
 
   //------------------------------- pmt sensitivity -------------------------------
-  //G4cout << "----- PMT sensitivity " << G4endl;
-  G4SDManager *pSDManager = G4SDManager::GetSDMpointer();
-
-  muensterTPCPmtSensitiveDetector *pPmtSD = new muensterTPCPmtSensitiveDetector("muensterTPC/PmtSD");
-  pSDManager->AddNewDetector(pPmtSD);
-  m_pPmtPhotoCathodeLogicalVolume->SetSensitiveDetector(pPmtSD);
+  // see ConstructSDandField
 
   //================================== optical surface =================================	
   //G4cout << "----- optical surface " << G4endl;
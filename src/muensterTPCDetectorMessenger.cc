@@ -22,12 +22,18 @@
 #include "muensterTPCDetectorMessenger.hh"
 
 #include "muensterTPCDetectorConstruction.hh"
+#include "muensterTPCLXeSensitiveDetector.hh"
+#include "muensterTPCPmtSensitiveDetector.hh"
+#include "muensterTPCSteppingAction.hh"
+#include "muensterTPCFastOptics.hh"
+#include "muensterTPCOpticalRayTracer.hh"
 
 muensterTPCDetectorMessenger::muensterTPCDetectorMessenger(muensterTPCDetectorConstruction *pXeDetector)
 :m_pXeDetector(pXeDetector)
 { 
 	m_pDetectorDir = new G4UIdirectory("/Xe/detector/");
 	m_pDetectorDir->SetGuidance("detector control.");
+	// geometry and materials are shared between threads, only the master applies these
 
 	// Not working - just a template
 	m_pLXeLevelCmd = new G4UIcmdWithADoubleAndUnit("/Xe/detector/setLXeLevel", this);
@@ -35,38 +41,45 @@ muensterTPCDetectorMessenger::muensterTPCDetectorMessenger(muensterTPCDetectorCo
 	m_pLXeLevelCmd->SetParameterName("LXeLevel", false);
 	m_pLXeLevelCmd->SetRange("LXeLevel >= 0.");
 	m_pLXeLevelCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeLevelCmd->SetToBeBroadcasted(false);
 
 	m_pMaterCmd = new G4UIcmdWithAString("/Xe/detector/setMat",this);
 	m_pMaterCmd->SetGuidance("Select material of the LXe volume.");
 	m_pMaterCmd->SetParameterName("choice",false);
 	m_pMaterCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pMaterCmd->SetToBeBroadcasted(false);
 
 	m_pLXeMeshMaterialCmd = new G4UIcmdWithAString("/Xe/detector/setLXeMeshMaterial",this);
 	m_pLXeMeshMaterialCmd->SetGuidance("Select material of the LXe Meshes.");
 	m_pLXeMeshMaterialCmd->SetParameterName("choice",false);
 	m_pLXeMeshMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeMeshMaterialCmd->SetToBeBroadcasted(false);
 
 	m_pGXeMeshMaterialCmd = new G4UIcmdWithAString("/Xe/detector/setGXeMeshMaterial",this);
 	m_pGXeMeshMaterialCmd->SetGuidance("Select material of the GXe Meshes.");
 	m_pGXeMeshMaterialCmd->SetParameterName("choice",false);
 	m_pGXeMeshMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pGXeMeshMaterialCmd->SetToBeBroadcasted(false);
 
 	m_pTeflonReflectivityCmd = new G4UIcmdWithADouble("/Xe/detector/setTeflonReflectivity", this);
 	m_pTeflonReflectivityCmd->SetGuidance("Define teflon reflectivity.");
 	m_pTeflonReflectivityCmd->SetParameterName("R", false);
 	m_pTeflonReflectivityCmd->SetRange("R >= 0. && R <= 1.");
 	m_pTeflonReflectivityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pTeflonReflectivityCmd->SetToBeBroadcasted(false);
 	
 	m_pGXeTeflonReflectivityCmd = new G4UIcmdWithADouble("/Xe/detector/setGXeTeflonReflectivity", this);
     m_pGXeTeflonReflectivityCmd->SetGuidance("Define teflon (into the GXe) reflectivity.");
     m_pGXeTeflonReflectivityCmd->SetParameterName("R", false);
     m_pGXeTeflonReflectivityCmd->SetRange("R >= 0. && R <= 1.");
     m_pGXeTeflonReflectivityCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    m_pGXeTeflonReflectivityCmd->SetToBeBroadcasted(false);
 
 	m_pLXeScintillationCmd = new G4UIcmdWithABool("/Xe/detector/setLXeScintillation", this);
 	m_pLXeScintillationCmd->SetGuidance("Switch on/off LXe scintillation in the sensitive volume.");
 	m_pLXeScintillationCmd->SetParameterName("LXeScint", false); 
 	m_pLXeScintillationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeScintillationCmd->SetToBeBroadcasted(false);
 
 	m_pLXeAbsorbtionLengthCmd = new G4UIcmdWithADoubleAndUnit("/Xe/detector/setLXeAbsorbtionLength", this);
 	m_pLXeAbsorbtionLengthCmd->SetGuidance("Define LXe absorbtion length.");
@@ -74,6 +87,7 @@ muensterTPCDetectorMessenger::muensterTPCDetectorMessenger(muensterTPCDetectorCo
 	m_pLXeAbsorbtionLengthCmd->SetRange("AbsL >= 0.");
 	m_pLXeAbsorbtionLengthCmd->SetUnitCategory("Length");
 	m_pLXeAbsorbtionLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeAbsorbtionLengthCmd->SetToBeBroadcasted(false);
 
 	m_pGXeAbsorbtionLengthCmd = new G4UIcmdWithADoubleAndUnit("/Xe/detector/setGXeAbsorbtionLength", this);
 	m_pGXeAbsorbtionLengthCmd->SetGuidance("Define GXe absorbtion length.");
@@ -81,6 +95,7 @@ muensterTPCDetectorMessenger::muensterTPCDetectorMessenger(muensterTPCDetectorCo
 	m_pGXeAbsorbtionLengthCmd->SetRange("GAbsL >= 0.");
 	m_pGXeAbsorbtionLengthCmd->SetUnitCategory("Length");
 	m_pGXeAbsorbtionLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pGXeAbsorbtionLengthCmd->SetToBeBroadcasted(false);
 
 	m_pLXeRayScatterLengthCmd = new G4UIcmdWithADoubleAndUnit("/Xe/detector/setLXeRayScatterLength", this);
 	m_pLXeRayScatterLengthCmd->SetGuidance("Define LXe Rayleigh Scattering length.");
@@ -88,24 +103,200 @@ muensterTPCDetectorMessenger::muensterTPCDetectorMessenger(muensterTPCDetectorCo
 	m_pLXeRayScatterLengthCmd->SetRange("ScatL >= 0.");
 	m_pLXeRayScatterLengthCmd->SetUnitCategory("Length");
 	m_pLXeRayScatterLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeRayScatterLengthCmd->SetToBeBroadcasted(false);
 	
 	m_pLXeMeshTransparencyCmd = new G4UIcmdWithADouble("/Xe/detector/setLXeMeshTransparency", this);
 	m_pLXeMeshTransparencyCmd->SetGuidance("Define LXe mesh transparency.");
 	m_pLXeMeshTransparencyCmd->SetParameterName("Transpa", false);
 	m_pLXeMeshTransparencyCmd->SetRange("Transpa >= 0. && Transpa <= 1.");
 	m_pLXeMeshTransparencyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeMeshTransparencyCmd->SetToBeBroadcasted(false);
 
 	m_pGXeMeshTransparencyCmd = new G4UIcmdWithADouble("/Xe/detector/setGXeMeshTransparency", this);
 	m_pGXeMeshTransparencyCmd->SetGuidance("Define GXe mesh transparency.");
 	m_pGXeMeshTransparencyCmd->SetParameterName("Transpa", false);
 	m_pGXeMeshTransparencyCmd->SetRange("Transpa >= 0. && Transpa <= 1.");
 	m_pGXeMeshTransparencyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pGXeMeshTransparencyCmd->SetToBeBroadcasted(false);
 
 	m_pLXeRefractionIndexCmd = new G4UIcmdWithADouble("/Xe/detector/setLXeRefractionIndex", this);
     m_pLXeRefractionIndexCmd->SetGuidance("Define LXe refraction index (MC: 1.63).");
     m_pLXeRefractionIndexCmd->SetParameterName("LXeR", false);
     m_pLXeRefractionIndexCmd->SetRange("LXeR >= 1.56 && LXeR <= 1.69");
     m_pLXeRefractionIndexCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+    m_pLXeRefractionIndexCmd->SetToBeBroadcasted(false);
+
+	// steps stored by the LXe sensitive detector (all threads)
+	m_pLXeEnergyThresholdCmd = new G4UIcmdWithADoubleAndUnit("/Xe/detector/setLXeEnergyThreshold", this);
+	m_pLXeEnergyThresholdCmd->SetGuidance("Store only steps in the LXe/GXe with an energy deposit above this threshold.");
+	m_pLXeEnergyThresholdCmd->SetGuidance("Default 0: steps without energy deposit are not stored.");
+	m_pLXeEnergyThresholdCmd->SetParameterName("EThr", false);
+	m_pLXeEnergyThresholdCmd->SetRange("EThr >= 0.");
+	m_pLXeEnergyThresholdCmd->SetUnitCategory("Energy");
+	m_pLXeEnergyThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeEnergyThresholdCmd->SetToBeBroadcasted(false);
+
+	m_pLXeParticlesCmd = new G4UIcmdWithAString("/Xe/detector/setLXeParticles", this);
+	m_pLXeParticlesCmd->SetGuidance("Store only steps of these particles in the LXe/GXe (optical photons are never stored).");
+	m_pLXeParticlesCmd->SetGuidance("[usage] /Xe/detector/setLXeParticles e- e+ gamma alpha neutron ions | all");
+	m_pLXeParticlesCmd->SetParameterName("particles", false);
+	m_pLXeParticlesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeParticlesCmd->SetToBeBroadcasted(false);
+
+	m_pLXeClusteringCmd = new G4UIcommand("/Xe/detector/setLXeClustering", this);
+	m_pLXeClusteringCmd->SetGuidance("Merge the energy deposits of a track family within this distance and time");
+	m_pLXeClusteringCmd->SetGuidance("into clusters (xc, yc, zc, edc, ...) instead of storing every step (distance 0 = off).");
+	m_pLXeClusteringCmd->SetGuidance("[usage] /Xe/detector/setLXeClustering 0.3 mm 5 ns");
+	G4UIparameter *pParameter = new G4UIparameter("distance", 'd', false);
+	pParameter->SetParameterRange("distance >= 0.");
+	m_pLXeClusteringCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("distanceUnit", 's', true);
+	pParameter->SetDefaultValue("mm");
+	m_pLXeClusteringCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("time", 'd', true);
+	pParameter->SetParameterRange("time >= 0.");
+	pParameter->SetDefaultValue("5");
+	m_pLXeClusteringCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("timeUnit", 's', true);
+	pParameter->SetDefaultValue("ns");
+	m_pLXeClusteringCmd->SetParameter(pParameter);
+	m_pLXeClusteringCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pLXeClusteringCmd->SetToBeBroadcasted(false);
+
+	m_pPmtHitsCmd = new G4UIcmdWithAString("/Xe/detector/setPmtHits", this);
+	m_pPmtHitsCmd->SetGuidance("counts: only the number of photons per pmt is counted (default).");
+	m_pPmtHitsCmd->SetGuidance("full: a hit with position and time is stored for every photon (timing studies).");
+	m_pPmtHitsCmd->SetParameterName("mode", false);
+	m_pPmtHitsCmd->SetCandidates("counts full");
+	m_pPmtHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pPmtHitsCmd->SetToBeBroadcasted(false);
+
+	m_pPmtTimeHistogramsCmd = new G4UIcommand("/Xe/detector/setPmtTimeHistograms", this);
+	m_pPmtTimeHistogramsCmd->SetGuidance("Histogram the photon arrival times (global time) per pmt and event");
+	m_pPmtTimeHistogramsCmd->SetGuidance("and store them with the first photon time in the branch pmttiming (0 bins = off).");
+	m_pPmtTimeHistogramsCmd->SetGuidance("[usage] /Xe/detector/setPmtTimeHistograms 100 0 500 ns");
+	pParameter = new G4UIparameter("nbins", 'i', false);
+	pParameter->SetParameterRange("nbins >= 0");
+	m_pPmtTimeHistogramsCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("tmin", 'd', true);
+	pParameter->SetDefaultValue("0");
+	m_pPmtTimeHistogramsCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("tmax", 'd', true);
+	pParameter->SetDefaultValue("500");
+	m_pPmtTimeHistogramsCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("timeUnit", 's', true);
+	pParameter->SetDefaultValue("ns");
+	m_pPmtTimeHistogramsCmd->SetParameter(pParameter);
+	m_pPmtTimeHistogramsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pPmtTimeHistogramsCmd->SetToBeBroadcasted(false);
+
+	// track killing for background simulations (all threads)
+	m_pKillVolumesCmd = new G4UIcmdWithAString("/Xe/detector/setKillVolumes", this);
+	m_pKillVolumesCmd->SetGuidance("Kill tracks leaving these physical volumes and their daughters (none = off).");
+	m_pKillVolumesCmd->SetGuidance("Particles scattered back from outside are lost, optical photons are not killed.");
+	m_pKillVolumesCmd->SetGuidance("[usage] /Xe/detector/setKillVolumes OuterCryostatVacuum,OuterCryostatVessel,OuterCryostatBoreFlange,OuterCryostatBlindFlange");
+	m_pKillVolumesCmd->SetParameterName("volumes", false);
+	m_pKillVolumesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pKillVolumesCmd->SetToBeBroadcasted(false);
+
+	m_pKillEnergyCmd = new G4UIcmdWithADoubleAndUnit("/Xe/detector/setKillEnergy", this);
+	m_pKillEnergyCmd->SetGuidance("Kill tracks below this kinetic energy outside the LXe/GXe (0 = off).");
+	m_pKillEnergyCmd->SetGuidance("Neutrons, nuclei and optical photons are not killed.");
+	m_pKillEnergyCmd->SetParameterName("EKill", false);
+	m_pKillEnergyCmd->SetRange("EKill >= 0.");
+	m_pKillEnergyCmd->SetUnitCategory("Energy");
+	m_pKillEnergyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pKillEnergyCmd->SetToBeBroadcasted(false);
+
+	m_pAbortOnPrimaryExitCmd = new G4UIcmdWithABool("/Xe/detector/setAbortOnPrimaryExit", this);
+	m_pAbortOnPrimaryExitCmd->SetGuidance("Abort the event when a primary leaves the kill volumes (setKillVolumes)");
+	m_pAbortOnPrimaryExitCmd->SetGuidance("before it interacted in the LXe/GXe (no deposits and no secondaries) and no other");
+	m_pAbortOnPrimaryExitCmd->SetGuidance("track is pending on the stack (default false).");
+	m_pAbortOnPrimaryExitCmd->SetParameterName("abort", false);
+	m_pAbortOnPrimaryExitCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pAbortOnPrimaryExitCmd->SetToBeBroadcasted(false);
+
+	// optical photons (all threads)
+	m_pOpticsDir = new G4UIdirectory("/Xe/optics/");
+	m_pOpticsDir->SetGuidance("Optical photon simulation control.");
+
+	m_pFastOpticsCmd = new G4UIcmdWithAString("/Xe/optics/fastOptics", this);
+	m_pFastOpticsCmd->SetGuidance("Kill the scintillation photons emitted inside the lce map at birth and sample the");
+	m_pFastOpticsCmd->SetGuidance("detected photons per pmt from the map (output file of an /Xe/output/lceMap run).");
+	m_pFastOpticsCmd->SetGuidance("Photons outside of the map and Cerenkov photons are tracked (off = full tracking, default).");
+	m_pFastOpticsCmd->SetGuidance("[usage] /Xe/optics/fastOptics lce_map.root | off");
+	m_pFastOpticsCmd->SetParameterName("file", false);
+	m_pFastOpticsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pFastOpticsCmd->SetToBeBroadcasted(false);
+
+	m_pRayTracerCmd = new G4UIcommand("/Xe/optics/rayTracer", this);
+	m_pRayTracerCmd->SetGuidance("Trace the optical photons inside the PTFE cylinder with the analytic model of the TPC");
+	m_pRayTracerCmd->SetGuidance("(fast simulation model of the LXe/GXe) in batches of photons instead of Geant4 stepping.");
+	m_pRayTracerCmd->SetGuidance("Only before /run/initialize (default off).");
+	m_pRayTracerCmd->SetGuidance("[usage] /Xe/optics/rayTracer true 1024");
+	pParameter = new G4UIparameter("enable", 'b', false);
+	m_pRayTracerCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("batchSize", 'i', true);
+	pParameter->SetDefaultValue("1024");
+	pParameter->SetParameterRange("batchSize > 0");
+	m_pRayTracerCmd->SetParameter(pParameter);
+	m_pRayTracerCmd->AvailableForStates(G4State_PreInit);
+	m_pRayTracerCmd->SetToBeBroadcasted(false);
+
+	m_pPmtEfficiencyCmd = new G4UIcmdWithAString("/Xe/optics/pmtEfficiency", this);
+	m_pPmtEfficiencyCmd->SetGuidance("Detection efficiency (QExCE) of the pmts, one value for all pmts or one value per pmt.");
+	m_pPmtEfficiencyCmd->SetGuidance("Optical photons are killed at their creation with the maximum efficiency, the pmts");
+	m_pPmtEfficiencyCmd->SetGuidance("detect the photons with their efficiency relative to the maximum (off = all photons, default).");
+	m_pPmtEfficiencyCmd->SetGuidance("[usage] /Xe/optics/pmtEfficiency 0.3 | 0.3 0.28 0.31 ... | off");
+	m_pPmtEfficiencyCmd->SetParameterName("efficiencies", false);
+	m_pPmtEfficiencyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pPmtEfficiencyCmd->SetToBeBroadcasted(false);
+
+	m_pPhotonMaxTrackLengthCmd = new G4UIcommand("/Xe/optics/setPhotonMaxTrackLength", this);
+	m_pPhotonMaxTrackLengthCmd->SetGuidance("Kill optical photons in the region with a longer track (0 = no limit, default).");
+	m_pPhotonMaxTrackLengthCmd->SetGuidance("Regions: LXe and GXe inside the PTFE cylinder, gaps outside of it or all.");
+	m_pPhotonMaxTrackLengthCmd->SetGuidance("[usage] /Xe/optics/setPhotonMaxTrackLength LXe 20 m");
+	pParameter = new G4UIparameter("region", 's', false);
+	pParameter->SetParameterCandidates("LXe GXe gaps all");
+	m_pPhotonMaxTrackLengthCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("length", 'd', false);
+	pParameter->SetParameterRange("length >= 0.");
+	m_pPhotonMaxTrackLengthCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("lengthUnit", 's', true);
+	pParameter->SetDefaultValue("m");
+	m_pPhotonMaxTrackLengthCmd->SetParameter(pParameter);
+	m_pPhotonMaxTrackLengthCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pPhotonMaxTrackLengthCmd->SetToBeBroadcasted(false);
+
+	m_pPhotonMaxTimeCmd = new G4UIcommand("/Xe/optics/setPhotonMaxTime", this);
+	m_pPhotonMaxTimeCmd->SetGuidance("Kill optical photons in the region after this global time (0 = no limit, default).");
+	m_pPhotonMaxTimeCmd->SetGuidance("Regions: LXe and GXe inside the PTFE cylinder, gaps outside of it or all.");
+	m_pPhotonMaxTimeCmd->SetGuidance("[usage] /Xe/optics/setPhotonMaxTime all 10 us");
+	pParameter = new G4UIparameter("region", 's', false);
+	pParameter->SetParameterCandidates("LXe GXe gaps all");
+	m_pPhotonMaxTimeCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("time", 'd', false);
+	pParameter->SetParameterRange("time >= 0.");
+	m_pPhotonMaxTimeCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("timeUnit", 's', true);
+	pParameter->SetDefaultValue("ns");
+	m_pPhotonMaxTimeCmd->SetParameter(pParameter);
+	m_pPhotonMaxTimeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pPhotonMaxTimeCmd->SetToBeBroadcasted(false);
+
+	m_pPhotonMaxBoundariesCmd = new G4UIcommand("/Xe/optics/setPhotonMaxBoundaries", this);
+	m_pPhotonMaxBoundariesCmd->SetGuidance("Kill optical photons in the region after this number of boundary interactions");
+	m_pPhotonMaxBoundariesCmd->SetGuidance("(reflections and refractions of the track, 0 = no limit, default).");
+	m_pPhotonMaxBoundariesCmd->SetGuidance("Regions: LXe and GXe inside the PTFE cylinder, gaps outside of it or all.");
+	m_pPhotonMaxBoundariesCmd->SetGuidance("[usage] /Xe/optics/setPhotonMaxBoundaries gaps 50");
+	pParameter = new G4UIparameter("region", 's', false);
+	pParameter->SetParameterCandidates("LXe GXe gaps all");
+	m_pPhotonMaxBoundariesCmd->SetParameter(pParameter);
+	pParameter = new G4UIparameter("boundaries", 'i', false);
+	pParameter->SetParameterRange("boundaries >= 0");
+	m_pPhotonMaxBoundariesCmd->SetParameter(pParameter);
+	m_pPhotonMaxBoundariesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+	m_pPhotonMaxBoundariesCmd->SetToBeBroadcasted(false);
 
 }
 
@@ -124,6 +315,21 @@ muensterTPCDetectorMessenger::~muensterTPCDetectorMessenger()
 	delete m_pLXeRefractionIndexCmd;
 	delete m_pLXeMeshTransparencyCmd;
 	delete m_pGXeMeshTransparencyCmd;
+	delete m_pLXeEnergyThresholdCmd;
+	delete m_pLXeParticlesCmd;
+	delete m_pLXeClusteringCmd;
+	delete m_pPmtHitsCmd;
+	delete m_pPmtTimeHistogramsCmd;
+	delete m_pKillVolumesCmd;
+	delete m_pKillEnergyCmd;
+	delete m_pAbortOnPrimaryExitCmd;
+	delete m_pFastOpticsCmd;
+	delete m_pRayTracerCmd;
+	delete m_pPmtEfficiencyCmd;
+	delete m_pPhotonMaxTrackLengthCmd;
+	delete m_pPhotonMaxTimeCmd;
+	delete m_pPhotonMaxBoundariesCmd;
+	delete m_pOpticsDir;
 
 	delete m_pDetectorDir;
 }
@@ -169,6 +375,92 @@ void muensterTPCDetectorMessenger::SetNewValue(G4UIcommand *pUIcommand, G4String
 
 	if(pUIcommand == m_pLXeRefractionIndexCmd)
       m_pXeDetector->SetLXeRefractionIndex(m_pLXeRefractionIndexCmd->GetNewDoubleValue(hNewValue));	  
-}
-
 
+	if(pUIcommand == m_pLXeEnergyThresholdCmd)
+		muensterTPCLXeSensitiveDetector::SetEnergyThreshold(m_pLXeEnergyThresholdCmd->GetNewDoubleValue(hNewValue));
+
+	if(pUIcommand == m_pLXeParticlesCmd)
+		muensterTPCLXeSensitiveDetector::SetParticles(hNewValue);
+
+	if(pUIcommand == m_pLXeClusteringCmd)
+	{
+		G4Tokenizer next(hNewValue);
+		G4double dDistance = StoD(next());
+		dDistance *= G4UIcommand::ValueOf(next());
+		G4double dTime = StoD(next());
+		dTime *= G4UIcommand::ValueOf(next());
+		muensterTPCLXeSensitiveDetector::SetClustering(dDistance, dTime);
+	}
+
+	if(pUIcommand == m_pPmtHitsCmd)
+		muensterTPCPmtSensitiveDetector::SetStoreHits(hNewValue == "full");
+
+	if(pUIcommand == m_pPmtTimeHistogramsCmd)
+	{
+		G4Tokenizer next(hNewValue);
+		G4int iNbTimeBins = StoI(next());
+		G4double dTimeMin = StoD(next());
+		G4double dTimeMax = StoD(next());
+		G4double dTimeUnit = G4UIcommand::ValueOf(next());
+		muensterTPCPmtSensitiveDetector::SetTimeHistograms(iNbTimeBins, dTimeMin*dTimeUnit, dTimeMax*dTimeUnit);
+	}
+
+	if(pUIcommand == m_pKillVolumesCmd)
+		muensterTPCSteppingAction::SetKillVolumes(hNewValue);
+
+	if(pUIcommand == m_pKillEnergyCmd)
+		muensterTPCSteppingAction::SetKillEnergy(m_pKillEnergyCmd->GetNewDoubleValue(hNewValue));
+
+	if(pUIcommand == m_pAbortOnPrimaryExitCmd)
+		muensterTPCSteppingAction::SetAbortOnPrimaryExit(m_pAbortOnPrimaryExitCmd->GetNewBoolValue(hNewValue));
+
+	if(pUIcommand == m_pFastOpticsCmd)
+	{
+		if(hNewValue == "off")
+			muensterTPCFastOptics::Disable();
+		else
+			muensterTPCFastOptics::LoadMap(hNewValue);
+	}
+
+	if(pUIcommand == m_pRayTracerCmd)
+	{
+		G4Tokenizer next(hNewValue);
+		muensterTPCOpticalRayTracer::SetEnabled(G4UIcommand::ConvertToBool(next()));
+		muensterTPCOpticalRayTracer::SetBatchSize(StoI(next()));
+	}
+	if(pUIcommand == m_pPmtEfficiencyCmd)
+	{
+		vector<G4double> hEfficiencies;
+		if(hNewValue != "off")
+		{
+			G4Tokenizer next(hNewValue);
+			for(G4String hEfficiency = next(); !hEfficiency.empty(); hEfficiency = next())
+				hEfficiencies.push_back(StoD(hEfficiency));
+		}
+		muensterTPCPmtSensitiveDetector::SetEfficiencies(hEfficiencies);
+	}
+	if(pUIcommand == m_pPhotonMaxTrackLengthCmd)
+	{
+		G4Tokenizer next(hNewValue);
+		G4String hRegion = next();
+		G4double dLength = StoD(next());
+		dLength *= G4UIcommand::ValueOf(next());
+		muensterTPCSteppingAction::SetPhotonMaxTrackLength(hRegion, dLength);
+	}
+
+	if(pUIcommand == m_pPhotonMaxTimeCmd)
+	{
+		G4Tokenizer next(hNewValue);
+		G4String hRegion = next();
+		G4double dTime = StoD(next());
+		dTime *= G4UIcommand::ValueOf(next());
+		muensterTPCSteppingAction::SetPhotonMaxTime(hRegion, dTime);
+	}
+
+	if(pUIcommand == m_pPhotonMaxBoundariesCmd)
+	{
+		G4Tokenizer next(hNewValue);
+		G4String hRegion = next();
+		muensterTPCSteppingAction::SetPhotonMaxBoundaries(hRegion, StoI(next()));
+	}
+}
@@ -23,16 +23,19 @@ muensterTPCEventAction::muensterTPCEventAction(muensterTPCAnalysisManager *pAnal
 	m_pAnalysisManager = pAnalysisManager;
 	time_un = time(0);
 	time_now = localtime(&time_un);
-
+	starttimeunix = mktime ( time_now );
+	m_iNbEventsToSimulate = 0;
 }
 
 muensterTPCEventAction::~muensterTPCEventAction() {
 }
 
 void muensterTPCEventAction::BeginOfEventAction(const G4Event *pEvent) {
+	// in multi-threaded mode event 0 is processed by one worker thread only
+	m_iNbEventsToSimulate = m_pAnalysisManager->GetNbEventsToSimulate();
+
 	if(pEvent->GetEventID() == 0)
 	{
-		m_iNbEventsToSimulate = m_pAnalysisManager->GetNbEventsToSimulate();
 		starttime.str(std::string());
 		starttime << time_now->tm_year+1900 << "-" << time_now->tm_mon+1 
 		     << "-" << time_now->tm_mday << " " << time_now->tm_hour
@@ -58,7 +61,7 @@ void muensterTPCEventAction::BeginOfEventAction(const G4Event *pEvent) {
 		G4cout << "================================================================" << G4endl;
 	}
 	
-	if ( (pEvent->GetEventID() % 1000 == 0) || (pEvent->GetEventID() % (m_iNbEventsToSimulate/5) == 0) )
+	if ( (pEvent->GetEventID() % 1000 == 0) || ((m_iNbEventsToSimulate >= 5) && (pEvent->GetEventID() % (m_iNbEventsToSimulate/5) == 0)) )
 	{
 		time_un = time(0);
 		time_now = localtime(&time_un);
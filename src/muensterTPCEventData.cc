@@ -8,14 +8,28 @@
  *
  * @comment 
  ******************************************************************/
+#include <algorithm>
+#include <utility>
+
 #include "muensterTPCEventData.hh"
 
 muensterTPCEventData::muensterTPCEventData()
 {
 	m_iEventId = 0;
+	m_lSeed0 = 0;
+	m_lSeed1 = 0;
+	m_iPostponed = 0;
 	m_iNbTopPmtHits = 0;
 	m_iNbBottomPmtHits = 0;
 	m_pPmtHits = new vector<int>;
+	m_pPmtId = new vector<int>;
+	m_pPmtCount = new vector<int>;
+	m_pPmtTiming = new vector<float>;
+	m_pPmtArea = new vector<float>;
+	m_pWaveformPmt = new vector<int>;
+	m_pWaveformStart = new vector<int>;
+	m_pWaveformLength = new vector<int>;
+	m_pWaveformData = new vector<float>;
 
 	m_fTotalEnergyDeposited = 0.;
 	m_iNbSteps = 0;
@@ -26,6 +40,10 @@ muensterTPCEventData::muensterTPCEventData()
 	m_pParentType = new vector<string>;
 	m_pCreatorProcess = new vector<string>;
 	m_pDepositingProcess = new vector<string>;
+	m_pParticleTypeCode = new vector<int>;
+	m_pParentTypeCode = new vector<int>;
+	m_pCreatorProcessCode = new vector<int>;
+	m_pDepositingProcessCode = new vector<int>;
 	m_pX = new vector<float>;
 	m_pY = new vector<float>;
 	m_pZ = new vector<float>;
@@ -33,7 +51,19 @@ muensterTPCEventData::muensterTPCEventData()
 	m_pKineticEnergy = new vector<float>;
 	m_pTime = new vector<float>;
 
+	m_iNbClusters = 0;
+	m_pClusterTrackId = new vector<int>;
+	m_pClusterType = new vector<string>;
+	m_pClusterTypeCode = new vector<int>;
+	m_pClusterX = new vector<float>;
+	m_pClusterY = new vector<float>;
+	m_pClusterZ = new vector<float>;
+	m_pClusterEnergyDeposited = new vector<float>;
+	m_pClusterTime = new vector<float>;
+	m_pClusterNbSteps = new vector<int>;
+
 	m_pPrimaryParticleType = new vector<string>;
+	m_pPrimaryParticleTypeCode = new vector<int>;
 	m_fPrimaryEnergy = 0.;
 	m_fPrimaryX = 0.;
 	m_fPrimaryY = 0.;
@@ -43,12 +73,24 @@ muensterTPCEventData::muensterTPCEventData()
 muensterTPCEventData::~muensterTPCEventData()
 {
 	delete m_pPmtHits;
+	delete m_pPmtId;
+	delete m_pPmtCount;
+	delete m_pPmtTiming;
+	delete m_pPmtArea;
+	delete m_pWaveformPmt;
+	delete m_pWaveformStart;
+	delete m_pWaveformLength;
+	delete m_pWaveformData;
 	delete m_pTrackId;
 	delete m_pParentId;
 	delete m_pParticleType;
 	delete m_pParentType;
 	delete m_pCreatorProcess;
 	delete m_pDepositingProcess;
+	delete m_pParticleTypeCode;
+	delete m_pParentTypeCode;
+	delete m_pCreatorProcessCode;
+	delete m_pDepositingProcessCode;
 	delete m_pX;
 	delete m_pY;
 	delete m_pZ;
@@ -56,27 +98,53 @@ muensterTPCEventData::~muensterTPCEventData()
 	delete m_pKineticEnergy;
 	delete m_pTime;
 
+	delete m_pClusterTrackId;
+	delete m_pClusterType;
+	delete m_pClusterTypeCode;
+	delete m_pClusterX;
+	delete m_pClusterY;
+	delete m_pClusterZ;
+	delete m_pClusterEnergyDeposited;
+	delete m_pClusterTime;
+	delete m_pClusterNbSteps;
+
 	delete m_pPrimaryParticleType;
+	delete m_pPrimaryParticleTypeCode;
 }
 
 void
 muensterTPCEventData::Clear()
 {
 	m_iEventId = 0;
+	m_lSeed0 = 0;
+	m_lSeed1 = 0;
+	m_iPostponed = 0;
 	m_iNbTopPmtHits = 0;
 	m_iNbBottomPmtHits = 0;
 
 	m_pPmtHits->clear();
+	m_pPmtId->clear();
+	m_pPmtCount->clear();
+	m_pPmtTiming->clear();
+	m_pPmtArea->clear();
+	m_pWaveformPmt->clear();
+	m_pWaveformStart->clear();
+	m_pWaveformLength->clear();
+	m_pWaveformData->clear();
 
 	m_fTotalEnergyDeposited = 0.0;
 	m_iNbSteps = 0;
 
 	m_pTrackId->clear();
 	m_pParentId->clear();
-	m_pParticleType->clear();
-	m_pParentType->clear();
-	m_pCreatorProcess->clear();
-	m_pDepositingProcess->clear();
+	ReleaseStrings(m_pParticleType);
+	ReleaseStrings(m_pParentType);
+	ReleaseStrings(m_pCreatorProcess);
+	ReleaseStrings(m_pDepositingProcess);
+	m_pParticleTypeCode->clear();
+	m_pParentTypeCode->clear();
+	m_pCreatorProcessCode->clear();
+	m_pDepositingProcessCode->clear();
 	m_pX->clear();
 	m_pY->clear();
 	m_pZ->clear();
@@ -84,10 +152,105 @@ muensterTPCEventData::Clear()
 	m_pKineticEnergy->clear();
 	m_pTime->clear();
 
-	m_pPrimaryParticleType->clear();
+	m_iNbClusters = 0;
+	m_pClusterTrackId->clear();
+	ReleaseStrings(m_pClusterType);
+	m_pClusterTypeCode->clear();
+	m_pClusterX->clear();
+	m_pClusterY->clear();
+	m_pClusterZ->clear();
+	m_pClusterEnergyDeposited->clear();
+	m_pClusterTime->clear();
+	m_pClusterNbSteps->clear();
+
+	ReleaseStrings(m_pPrimaryParticleType);
+	m_pPrimaryParticleTypeCode->clear();
 	m_fPrimaryEnergy = 0.;
 	m_fPrimaryX = 0.;
 	m_fPrimaryY = 0.;
 	m_fPrimaryZ = 0.;	
 }
 
+// exchange the contents with another record, the vectors keep their memory
+void
+muensterTPCEventData::Swap(muensterTPCEventData &hEventData)
+{
+	std::swap(m_iEventId, hEventData.m_iEventId);
+	std::swap(m_lSeed0, hEventData.m_lSeed0);
+	std::swap(m_lSeed1, hEventData.m_lSeed1);
+	std::swap(m_iPostponed, hEventData.m_iPostponed);
+	std::swap(m_iNbTopPmtHits, hEventData.m_iNbTopPmtHits);
+	std::swap(m_iNbBottomPmtHits, hEventData.m_iNbBottomPmtHits);
+	std::swap(m_iNbTopVetoPmtHits, hEventData.m_iNbTopVetoPmtHits);
+	std::swap(m_iNbBottomVetoPmtHits, hEventData.m_iNbBottomVetoPmtHits);
+	m_pPmtHits->swap(*hEventData.m_pPmtHits);
+	m_pPmtId->swap(*hEventData.m_pPmtId);
+	m_pPmtCount->swap(*hEventData.m_pPmtCount);
+	m_pPmtTiming->swap(*hEventData.m_pPmtTiming);
+	m_pPmtArea->swap(*hEventData.m_pPmtArea);
+	m_pWaveformPmt->swap(*hEventData.m_pWaveformPmt);
+	m_pWaveformStart->swap(*hEventData.m_pWaveformStart);
+	m_pWaveformLength->swap(*hEventData.m_pWaveformLength);
+	m_pWaveformData->swap(*hEventData.m_pWaveformData);
+	std::swap(m_fTotalEnergyDeposited, hEventData.m_fTotalEnergyDeposited);
+	std::swap(m_iNbSteps, hEventData.m_iNbSteps);
+	m_pTrackId->swap(*hEventData.m_pTrackId);
+	m_pParentId->swap(*hEventData.m_pParentId);
+	m_pParticleType->swap(*hEventData.m_pParticleType);
+	m_pParentType->swap(*hEventData.m_pParentType);
+	m_pCreatorProcess->swap(*hEventData.m_pCreatorProcess);
+	m_pDepositingProcess->swap(*hEventData.m_pDepositingProcess);
+	m_pParticleTypeCode->swap(*hEventData.m_pParticleTypeCode);
+	m_pParentTypeCode->swap(*hEventData.m_pParentTypeCode);
+	m_pCreatorProcessCode->swap(*hEventData.m_pCreatorProcessCode);
+	m_pDepositingProcessCode->swap(*hEventData.m_pDepositingProcessCode);
+	m_pX->swap(*hEventData.m_pX);
+	m_pY->swap(*hEventData.m_pY);
+	m_pZ->swap(*hEventData.m_pZ);
+	m_pEnergyDeposited->swap(*hEventData.m_pEnergyDeposited);
+	m_pKineticEnergy->swap(*hEventData.m_pKineticEnergy);
+	m_pTime->swap(*hEventData.m_pTime);
+	std::swap(m_iNbClusters, hEventData.m_iNbClusters);
+	m_pClusterTrackId->swap(*hEventData.m_pClusterTrackId);
+	m_pClusterType->swap(*hEventData.m_pClusterType);
+	m_pClusterTypeCode->swap(*hEventData.m_pClusterTypeCode);
+	m_pClusterX->swap(*hEventData.m_pClusterX);
+	m_pClusterY->swap(*hEventData.m_pClusterY);
+	m_pClusterZ->swap(*hEventData.m_pClusterZ);
+	m_pClusterEnergyDeposited->swap(*hEventData.m_pClusterEnergyDeposited);
+	m_pClusterTime->swap(*hEventData.m_pClusterTime);
+	m_pClusterNbSteps->swap(*hEventData.m_pClusterNbSteps);
+	m_pPrimaryParticleType->swap(*hEventData.m_pPrimaryParticleType);
+	m_pPrimaryParticleTypeCode->swap(*hEventData.m_pPrimaryParticleTypeCode);
+	std::swap(m_fPrimaryEnergy, hEventData.m_fPrimaryEnergy);
+	std::swap(m_fPrimaryX, hEventData.m_fPrimaryX);
+	std::swap(m_fPrimaryY, hEventData.m_fPrimaryY);
+	std::swap(m_fPrimaryZ, hEventData.m_fPrimaryZ);
+	// the pool goes with the released strings, records cleared by the writer thread refill it
+	m_hStringPool.swap(hEventData.m_hStringPool);
+}
+
+// the vectors keep their capacity after clear, the strings are moved
+// into the pool instead of being freed
+void
+muensterTPCEventData::ReleaseStrings(vector<string> *pStrings)
+{
+	for(size_t i=0; i<pStrings->size(); i++)
+		m_hStringPool.push_back(std::move((*pStrings)[i]));
+	pStrings->clear();
+}
+
+void
+muensterTPCEventData::PushBack(vector<string> *pStrings, const string &hString)
+{
+	if(m_hStringPool.empty())
+	{
+		pStrings->push_back(hString);
+		return;
+	}
+
+	pStrings->push_back(std::move(m_hStringPool.back()));
+	m_hStringPool.pop_back();
+	pStrings->back().assign(hString);
+}
+
@@ -0,0 +1,230 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include <G4SystemOfUnits.hh>
+#include <G4Tokenizer.hh>
+#include <G4ios.hh>
+
+#include "muensterTPCEventFilter.hh"
+#include "muensterTPCLXeHitStore.hh"
+#include "muensterTPCPmtSensitiveDetector.hh"
+#include "muensterTPCDetectorConstruction.hh"
+
+muensterTPCEventFilter::muensterTPCEventFilter()
+{
+	Reset();
+
+	m_iNbTopPmts = 0;
+	m_iNbBottomPmts = 0;
+
+	for(G4int i=0; i<NB_FILTERS; i++)
+		m_lNbTested[i] = m_lNbPassed[i] = 0;
+}
+
+muensterTPCEventFilter::~muensterTPCEventFilter()
+{
+}
+
+// all filters off
+void muensterTPCEventFilter::Reset()
+{
+	for(G4int i=0; i<NB_FILTERS; i++)
+		m_bEnabled[i] = false;
+
+	m_hPrimaryTypes.clear();
+	m_iMinTopPmtHits = 0;
+	m_iMinBottomPmtHits = 0;
+	m_dMinEnergy = 0.;
+	m_dMaxEnergy = 0.;
+	m_dMinFiducialEnergy = 0.;
+	m_dMaxFiducialEnergy = 0.;
+	m_bFiducialVolumeSet = false;
+	m_dFiducialMaxRadius = 0.;
+	m_dFiducialMinZ = 0.;
+	m_dFiducialMaxZ = 0.;
+}
+
+void muensterTPCEventFilter::SetPrimaryTypes(const G4String &hPrimaryTypes)
+{
+	m_hPrimaryTypes.clear();
+
+	// separated by spaces or commas, all: any primary
+	G4Tokenizer next(hPrimaryTypes);
+	for(G4String hPrimaryType = next(" ,"); !hPrimaryType.empty(); hPrimaryType = next(" ,"))
+	{
+		if(hPrimaryType != "all")
+			m_hPrimaryTypes.insert(hPrimaryType);
+	}
+
+	m_bEnabled[PRIMARY_TYPE] = !m_hPrimaryTypes.empty();
+}
+
+void muensterTPCEventFilter::SetMinPmtHits(G4int iMinTopPmtHits, G4int iMinBottomPmtHits)
+{
+	m_iMinTopPmtHits = iMinTopPmtHits;
+	m_iMinBottomPmtHits = iMinBottomPmtHits;
+	m_bEnabled[PMT_HITS] = (iMinTopPmtHits > 0 || iMinBottomPmtHits > 0);
+}
+
+void muensterTPCEventFilter::SetEnergyRange(G4double dMinEnergy, G4double dMaxEnergy)
+{
+	m_dMinEnergy = dMinEnergy;
+	m_dMaxEnergy = dMaxEnergy;
+	m_bEnabled[ENERGY] = (dMaxEnergy > dMinEnergy);
+}
+
+void muensterTPCEventFilter::SetFiducialEnergyRange(G4double dMinEnergy, G4double dMaxEnergy)
+{
+	m_dMinFiducialEnergy = dMinEnergy;
+	m_dMaxFiducialEnergy = dMaxEnergy;
+	m_bEnabled[FIDUCIAL_ENERGY] = (dMaxEnergy > dMinEnergy);
+}
+
+void muensterTPCEventFilter::SetFiducialVolume(G4double dMaxRadius, G4double dMinZ, G4double dMaxZ)
+{
+	m_bFiducialVolumeSet = true;
+	m_dFiducialMaxRadius = dMaxRadius;
+	m_dFiducialMinZ = dMinZ;
+	m_dFiducialMaxZ = dMaxZ;
+}
+
+G4bool muensterTPCEventFilter::IsEnabled()
+{
+	for(G4int i=0; i<NB_FILTERS; i++)
+		if(m_bEnabled[i])
+			return true;
+
+	return false;
+}
+
+//******************************************************************/
+// statistics and geometry of this run, the default fiducial volume
+// is the drift region between the cathode and gate meshes inside the teflon cylinder
+//******************************************************************/
+void muensterTPCEventFilter::Initialize(G4int iNbTopPmts, G4int iNbBottomPmts)
+{
+	m_iNbTopPmts = iNbTopPmts;
+	m_iNbBottomPmts = iNbBottomPmts;
+
+	if(!m_bFiducialVolumeSet)
+	{
+		G4double dHalfMeshThickness = 0.5*muensterTPCDetectorConstruction::GetGeometryParameter("GridMeshThickness");
+		m_dFiducialMaxRadius = muensterTPCDetectorConstruction::GetGeometryParameter("TeflonCentralCylinderInnerRadius");
+		m_dFiducialMinZ = muensterTPCDetectorConstruction::GetGeometryParameter("CathodeMeshZ")+dHalfMeshThickness;
+		m_dFiducialMaxZ = muensterTPCDetectorConstruction::GetGeometryParameter("GateMeshZ")-dHalfMeshThickness;
+	}
+
+	for(G4int i=0; i<NB_FILTERS; i++)
+		m_lNbTested[i] = m_lNbPassed[i] = 0;
+}
+
+//******************************************************************/
+// the enabled filters in the order of their cost, the event is
+// rejected by the first failing filter
+//******************************************************************/
+G4bool muensterTPCEventFilter::Accept(const G4String &hPrimaryType, muensterTPCLXeHitStore *pLXeHitStore,
+	muensterTPCLXeClustersCollection *pLXeClustersCollection, muensterTPCPmtSensitiveDetector *pPmtSD)
+{
+	if(m_bEnabled[PRIMARY_TYPE])
+	{
+		if(!Count(PRIMARY_TYPE, m_hPrimaryTypes.count(hPrimaryType) > 0))
+			return false;
+	}
+
+	if(m_bEnabled[PMT_HITS])
+	{
+		G4int iNbTopPmtHits = 0, iNbBottomPmtHits = 0;
+		if(pPmtSD)
+		{
+			const vector<G4int> &hHitPmts = pPmtSD->GetHitPmts();
+			for(size_t i=0; i<hHitPmts.size(); i++)
+			{
+				if(hHitPmts[i] < m_iNbTopPmts)
+					iNbTopPmtHits += pPmtSD->GetPmtCounts()[hHitPmts[i]];
+				else if(hHitPmts[i] < m_iNbTopPmts+m_iNbBottomPmts)
+					iNbBottomPmtHits += pPmtSD->GetPmtCounts()[hHitPmts[i]];
+			}
+		}
+
+		if(!Count(PMT_HITS, iNbTopPmtHits >= m_iMinTopPmtHits && iNbBottomPmtHits >= m_iMinBottomPmtHits))
+			return false;
+	}
+
+	if(!m_bEnabled[ENERGY] && !m_bEnabled[FIDUCIAL_ENERGY])
+		return true;
+
+	// steps or clusters, one pass for both energies
+	G4double dEnergy = 0., dFiducialEnergy = 0.;
+	G4double dMaxRadius2 = m_dFiducialMaxRadius*m_dFiducialMaxRadius;
+
+	G4int iNbLXeHits = (pLXeHitStore)?(pLXeHitStore->GetNbHits()):(0);
+	for(G4int i=0; i<iNbLXeHits; i++)
+	{
+		G4double dEnergyDeposited = pLXeHitStore->GetEnergiesDeposited()[i];
+		dEnergy += dEnergyDeposited;
+
+		G4double dX = pLXeHitStore->GetX()[i], dY = pLXeHitStore->GetY()[i], dZ = pLXeHitStore->GetZ()[i];
+		if(dZ > m_dFiducialMinZ && dZ < m_dFiducialMaxZ && dX*dX+dY*dY < dMaxRadius2)
+			dFiducialEnergy += dEnergyDeposited;
+	}
+
+	G4int iNbLXeClusters = (pLXeClustersCollection)?(pLXeClustersCollection->entries()):(0);
+	for(G4int i=0; i<iNbLXeClusters; i++)
+	{
+		muensterTPCLXeCluster *pCluster = (*pLXeClustersCollection)[i];
+		dEnergy += pCluster->GetEnergyDeposited();
+
+		G4ThreeVector hPosition = pCluster->GetPosition();
+		if(hPosition.z() > m_dFiducialMinZ && hPosition.z() < m_dFiducialMaxZ && hPosition.perp2() < dMaxRadius2)
+			dFiducialEnergy += pCluster->GetEnergyDeposited();
+	}
+
+	if(m_bEnabled[ENERGY])
+	{
+		if(!Count(ENERGY, dEnergy >= m_dMinEnergy && dEnergy < m_dMaxEnergy))
+			return false;
+	}
+
+	if(m_bEnabled[FIDUCIAL_ENERGY])
+	{
+		if(!Count(FIDUCIAL_ENERGY, dFiducialEnergy >= m_dMinFiducialEnergy && dFiducialEnergy < m_dMaxFiducialEnergy))
+			return false;
+	}
+
+	return true;
+}
+
+G4bool muensterTPCEventFilter::Count(G4int iFilter, G4bool bPassed)
+{
+	m_lNbTested[iFilter]++;
+	if(bPassed)
+		m_lNbPassed[iFilter]++;
+
+	return bPassed;
+}
+
+void muensterTPCEventFilter::PrintStatistics()
+{
+	if(!IsEnabled())
+		return;
+
+	const char *szFilterNames[NB_FILTERS] = {"primary type", "pmt hits", "energy", "fiducial energy"};
+
+	G4cout << "Event filter:";
+	for(G4int i=0; i<NB_FILTERS; i++)
+	{
+		if(!m_bEnabled[i])
+			continue;
+
+		G4cout << " " << szFilterNames[i] << " " << m_lNbPassed[i] << "/" << m_lNbTested[i];
+		if(m_lNbTested[i] > 0)
+			G4cout << " (" << 100.*m_lNbPassed[i]/m_lNbTested[i] << "%)";
+		G4cout << ((i < NB_FILTERS-1)?(","):(""));
+	}
+	G4cout << G4endl;
+}
+
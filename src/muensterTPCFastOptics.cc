@@ -0,0 +1,206 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+#include <G4ios.hh>
+
+#include <cmath>
+
+#include <TH3D.h>
+#include <TFile.h>
+#include <TString.h>
+#include <TParameter.h>
+
+#include "muensterTPCFastOptics.hh"
+#include "muensterTPCPmtSensitiveDetector.hh"
+
+G4bool muensterTPCFastOptics::m_bCartesian = false;
+G4int muensterTPCFastOptics::m_iNbBins[3] = {0, 0, 0};
+G4double muensterTPCFastOptics::m_dMin[3] = {0., 0., 0.};
+G4double muensterTPCFastOptics::m_dMax[3] = {0., 0., 0.};
+G4int muensterTPCFastOptics::m_iNbPmts = 0;
+vector<float> muensterTPCFastOptics::m_hLce;
+
+muensterTPCFastOptics::muensterTPCFastOptics()
+{
+	m_lNbKilledPhotons = 0;
+	m_lNbDetectedPhotons = 0;
+}
+
+muensterTPCFastOptics::~muensterTPCFastOptics()
+{
+}
+
+//******************************************************************/
+// lce/lce_<pmt> of a (merged) output file of an /Xe/output/lceMap run
+//******************************************************************/
+G4bool muensterTPCFastOptics::LoadMap(const G4String &hFileName)
+{
+	TFile *pFile = TFile::Open(hFileName.c_str(), "READ");
+	if(!pFile || pFile->IsZombie())
+	{
+		G4cout << "!!!!> fast optics: could not open the lce map " << hFileName << ", the map is not changed." << G4endl;
+		delete pFile;
+		return false;
+	}
+
+	vector<TH3D *> hMaps;
+	for(G4int iPmtNb=0; ; iPmtNb++)
+	{
+		TH3D *pMap = (TH3D *) pFile->Get(Form("lce/lce_%d", iPmtNb));
+		if(!pMap)
+			break;
+		pMap->SetDirectory(0);
+		hMaps.push_back(pMap);
+	}
+
+	if(hMaps.empty())
+	{
+		G4cout << "!!!!> fast optics: no lce/lce_<pmt> maps in " << hFileName << ", the map is not changed." << G4endl;
+		pFile->Close();
+		delete pFile;
+		return false;
+	}
+
+	TParameter<int> *pCartesian = (TParameter<int> *) pFile->Get("lce/cartesian");
+	m_bCartesian = (pCartesian)?(pCartesian->GetVal() != 0):(TString(hMaps[0]->GetXaxis()->GetTitle()).BeginsWith("x"));
+	delete pCartesian;
+
+	TAxis *pAxes[3] = {hMaps[0]->GetXaxis(), hMaps[0]->GetYaxis(), hMaps[0]->GetZaxis()};
+	for(G4int i=0; i<3; i++)
+	{
+		m_iNbBins[i] = pAxes[i]->GetNbins();
+		m_dMin[i] = pAxes[i]->GetXmin();
+		m_dMax[i] = pAxes[i]->GetXmax();
+	}
+
+	// pmt index innermost, the probabilities of one bin are contiguous
+	m_iNbPmts = hMaps.size();
+	G4int iNbBins = m_iNbBins[0]*m_iNbBins[1]*m_iNbBins[2];
+	m_hLce.assign(iNbBins*m_iNbPmts, 0.f);
+	for(G4int iPmtNb=0; iPmtNb<m_iNbPmts; iPmtNb++)
+	{
+		for(G4int iBin3=0; iBin3<m_iNbBins[2]; iBin3++)
+			for(G4int iBin2=0; iBin2<m_iNbBins[1]; iBin2++)
+				for(G4int iBin1=0; iBin1<m_iNbBins[0]; iBin1++)
+				{
+					G4int iBin = (iBin3*m_iNbBins[1]+iBin2)*m_iNbBins[0]+iBin1;
+					m_hLce[iBin*m_iNbPmts+iPmtNb] = hMaps[iPmtNb]->GetBinContent(iBin1+1, iBin2+1, iBin3+1);
+				}
+		delete hMaps[iPmtNb];
+	}
+
+	pFile->Close();
+	delete pFile;
+
+	G4cout << "Fast optics: " << m_iNbPmts << " pmts, " << m_iNbBins[0] << "x" << m_iNbBins[1] << "x" << m_iNbBins[2]
+		<< ((m_bCartesian)?(" xyz"):(" rphiz")) << " bins from " << hFileName << G4endl;
+
+	return true;
+}
+
+void muensterTPCFastOptics::Disable()
+{
+	m_iNbPmts = 0;
+	m_hLce.clear();
+}
+
+void muensterTPCFastOptics::Initialize()
+{
+	m_hBinPhotons.assign(m_iNbBins[0]*m_iNbBins[1]*m_iNbBins[2], 0);
+	m_hEmissionBins.clear();
+
+	m_lNbKilledPhotons = 0;
+	m_lNbDetectedPhotons = 0;
+}
+
+//******************************************************************/
+// bin of the emission position, -1 outside of the map
+//******************************************************************/
+G4int muensterTPCFastOptics::FindBin(const G4ThreeVector &hPosition)
+{
+	G4double dCoordinates[3];
+	if(m_bCartesian)
+	{
+		dCoordinates[0] = hPosition.x()/mm;
+		dCoordinates[1] = hPosition.y()/mm;
+	}
+	else
+	{
+		dCoordinates[0] = hPosition.perp()/mm;
+		dCoordinates[1] = hPosition.phi()/deg;
+	}
+	dCoordinates[2] = hPosition.z()/mm;
+
+	G4int iBin = 0;
+	for(G4int i=2; i>=0; i--)
+	{
+		if(dCoordinates[i] < m_dMin[i] || dCoordinates[i] >= m_dMax[i])
+			return -1;
+
+		G4int iAxisBin = (G4int) ((dCoordinates[i]-m_dMin[i])/(m_dMax[i]-m_dMin[i])*m_iNbBins[i]);
+		iBin = iBin*m_iNbBins[i] + std::min(iAxisBin, m_iNbBins[i]-1);
+	}
+
+	return iBin;
+}
+
+G4bool muensterTPCFastOptics::AddPhoton(const G4ThreeVector &hPosition)
+{
+	G4int iBin = FindBin(hPosition);
+	if(iBin < 0)
+		return false;
+
+	if(m_hBinPhotons[iBin]++ == 0)
+		m_hEmissionBins.push_back(iBin);
+	m_lNbKilledPhotons++;
+
+	return true;
+}
+
+//******************************************************************/
+// multinomial sampling per emission bin as a chain of binomials:
+// pmt i gets Binomial(n, p_i/(1-p_0-..-p_i-1)) of the n photons left
+//******************************************************************/
+void muensterTPCFastOptics::EndOfEvent(muensterTPCPmtSensitiveDetector *pPmtSD)
+{
+	for(size_t i=0; i<m_hEmissionBins.size(); i++)
+	{
+		G4int iBin = m_hEmissionBins[i];
+		G4long lNbPhotons = m_hBinPhotons[iBin];
+		m_hBinPhotons[iBin] = 0;
+
+		const float *pLce = &m_hLce[iBin*m_iNbPmts];
+		G4double dRemainingProbability = 1.;
+		for(G4int iPmtNb=0; iPmtNb<m_iNbPmts && lNbPhotons > 0 && dRemainingProbability > 0.; iPmtNb++)
+		{
+			if(pLce[iPmtNb] <= 0.f)
+				continue;
+
+			G4double dProbability = std::min(1., pLce[iPmtNb]/dRemainingProbability);
+			G4long lNbDetected = (G4long) CLHEP::RandBinomial::shoot(lNbPhotons, dProbability);
+			dRemainingProbability -= pLce[iPmtNb];
+
+			if(lNbDetected > 0)
+			{
+				if(pPmtSD)
+					pPmtSD->AddCounts(iPmtNb, lNbDetected);
+				m_lNbDetectedPhotons += lNbDetected;
+				lNbPhotons -= lNbDetected;
+			}
+		}
+	}
+	m_hEmissionBins.clear();
+}
+
+void muensterTPCFastOptics::PrintStatistics()
+{
+	G4cout << "Fast optics: " << m_lNbKilledPhotons << " scintillation photons killed at birth, "
+		<< m_lNbDetectedPhotons << " detected photons sampled" << G4endl;
+}
+
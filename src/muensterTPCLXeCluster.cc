@@ -0,0 +1,71 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include "G4SystemOfUnits.hh"
+
+#include "muensterTPCLXeCluster.hh"
+
+G4ThreadLocal G4Allocator<muensterTPCLXeCluster> *muensterTPCLXeClusterAllocator = 0;
+
+muensterTPCLXeCluster::muensterTPCLXeCluster()
+{
+	m_iTrackId = 0;
+	m_iFamilyId = 0;
+	m_pParticleDefinition = 0;
+	m_dEnergyDeposited = 0.;
+	m_dWeightedTime = 0.;
+	m_iNbSteps = 0;
+}
+
+muensterTPCLXeCluster::~muensterTPCLXeCluster() {}
+
+muensterTPCLXeCluster::muensterTPCLXeCluster(const muensterTPCLXeCluster &hmuensterTPCLXeCluster):G4VHit()
+{
+	*this = hmuensterTPCLXeCluster;
+}
+
+const muensterTPCLXeCluster &
+muensterTPCLXeCluster::operator=(const muensterTPCLXeCluster &hmuensterTPCLXeCluster)
+{
+	m_iTrackId = hmuensterTPCLXeCluster.m_iTrackId;
+	m_iFamilyId = hmuensterTPCLXeCluster.m_iFamilyId;
+	m_pParticleDefinition = hmuensterTPCLXeCluster.m_pParticleDefinition;
+	m_hWeightedPosition = hmuensterTPCLXeCluster.m_hWeightedPosition;
+	m_dEnergyDeposited = hmuensterTPCLXeCluster.m_dEnergyDeposited;
+	m_dWeightedTime = hmuensterTPCLXeCluster.m_dWeightedTime;
+	m_iNbSteps = hmuensterTPCLXeCluster.m_iNbSteps;
+
+	return *this;
+}
+
+G4int
+muensterTPCLXeCluster::operator==(const muensterTPCLXeCluster &hmuensterTPCLXeCluster) const
+{
+	return ((this == &hmuensterTPCLXeCluster) ? (1) : (0));
+}
+
+void muensterTPCLXeCluster::AddDeposit(const G4ThreeVector &hPosition, G4double dEnergyDeposited, G4double dTime)
+{
+	m_hWeightedPosition += dEnergyDeposited*hPosition;
+	m_dWeightedTime += dEnergyDeposited*dTime;
+	m_dEnergyDeposited += dEnergyDeposited;
+	m_iNbSteps++;
+}
+
+void muensterTPCLXeCluster::Print()
+{
+	G4cout << "LXe cluster ---> "
+		<< "Track: " << m_iTrackId
+		<< " Family: " << m_iFamilyId
+		<< " Position: " << GetPosition().x()/mm
+		<< " " << GetPosition().y()/mm
+		<< " " << GetPosition().z()/mm
+		<< " mm"
+		<< " Energy: " << m_dEnergyDeposited/keV << " keV"
+		<< " Time: " << GetTime()/ns << " ns"
+		<< " Steps: " << m_iNbSteps << G4endl;
+}
@@ -0,0 +1,86 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include "muensterTPCLXeHitStore.hh"
+
+const G4String muensterTPCLXeHitStore::m_hNoParentType = "none";
+const G4String muensterTPCLXeHitStore::m_hNoProcess = "Null";
+
+muensterTPCLXeHitStore::muensterTPCLXeHitStore()
+{
+}
+
+muensterTPCLXeHitStore::~muensterTPCLXeHitStore()
+{
+}
+
+// clear keeps the capacity of the arrays
+void muensterTPCLXeHitStore::Clear()
+{
+	m_hTrackId.clear();
+	m_hParentId.clear();
+	m_hParticleDefinition.clear();
+	m_hParentDefinition.clear();
+	m_hCreatorProcess.clear();
+	m_hDepositingProcess.clear();
+	m_hX.clear();
+	m_hY.clear();
+	m_hZ.clear();
+	m_hEnergyDeposited.clear();
+	m_hKineticEnergy.clear();
+	m_hTime.clear();
+}
+
+void muensterTPCLXeHitStore::AddHit(G4int iTrackId, G4int iParentId, const G4ParticleDefinition *pParticleDefinition, const G4ParticleDefinition *pParentDefinition,
+	const G4VProcess *pCreatorProcess, const G4VProcess *pDepositingProcess, const G4ThreeVector &hPosition,
+	G4double dEnergyDeposited, G4double dKineticEnergy, G4double dTime)
+{
+	m_hTrackId.push_back(iTrackId);
+	m_hParentId.push_back(iParentId);
+	m_hParticleDefinition.push_back(pParticleDefinition);
+	m_hParentDefinition.push_back(pParentDefinition);
+	m_hCreatorProcess.push_back(pCreatorProcess);
+	m_hDepositingProcess.push_back(pDepositingProcess);
+	m_hX.push_back(hPosition.x());
+	m_hY.push_back(hPosition.y());
+	m_hZ.push_back(hPosition.z());
+	m_hEnergyDeposited.push_back(dEnergyDeposited);
+	m_hKineticEnergy.push_back(dKineticEnergy);
+	m_hTime.push_back(dTime);
+}
+
+const G4String &muensterTPCLXeHitStore::GetParticleName(const G4ParticleDefinition *pParticleDefinition)
+{
+	return (pParticleDefinition)?(pParticleDefinition->GetParticleName()):(m_hNoParentType);
+}
+
+const G4String &muensterTPCLXeHitStore::GetProcessName(const G4VProcess *pProcess)
+{
+	return (pProcess)?(pProcess->GetProcessName()):(m_hNoProcess);
+}
+
+//******************************************************************/
+// one multiplication per element on contiguous arrays, vectorized by
+// the compiler
+//******************************************************************/
+void muensterTPCLXeHitStore::AppendInUnit(const vector<float> &hValues, G4double dUnit, vector<float> *pOutput)
+{
+	if(hValues.empty())
+		return;
+
+	size_t iOffset = pOutput->size();
+	pOutput->resize(iOffset+hValues.size());
+
+	const float *pIn = &hValues[0];
+	float *pOut = &(*pOutput)[iOffset];
+	const float fScale = (float) (1./dUnit);
+	const size_t iNbValues = hValues.size();
+
+	for(size_t i=0; i<iNbValues; i++)
+		pOut[i] = pIn[i]*fScale;
+}
+
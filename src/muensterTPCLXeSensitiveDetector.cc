@@ -13,17 +13,36 @@
 #include <G4VProcess.hh>
 #include <G4ThreeVector.hh>
 #include <G4SDManager.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Tokenizer.hh>
+#include <G4SystemOfUnits.hh>
 #include <G4ios.hh>
 
 #include <map>
+#include <cmath>
+#include <algorithm>
+#include <limits>
 
 using std::map;
 
 #include "muensterTPCLXeSensitiveDetector.hh"
 
+G4double muensterTPCLXeSensitiveDetector::m_dEnergyThreshold = 0.;
+set<G4String> muensterTPCLXeSensitiveDetector::m_hParticleNames;
+G4double muensterTPCLXeSensitiveDetector::m_dClusterDistance = 0.;
+G4double muensterTPCLXeSensitiveDetector::m_dClusterTime = 0.;
+
 muensterTPCLXeSensitiveDetector::muensterTPCLXeSensitiveDetector(G4String hName): G4VSensitiveDetector(hName)
 {
-	collectionName.insert("LXeHitsCollection");
+	collectionName.insert("LXeClustersCollection");
+
+	m_iClustersCollectionID = -1;
+	m_pLXeClustersCollection = 0;
+	m_bHasSecondaries = false;
+
+	m_iGeneration = 0;
+
+	ResetStatistics();
 }
 
 muensterTPCLXeSensitiveDetector::~muensterTPCLXeSensitiveDetector()
@@ -32,16 +51,26 @@ muensterTPCLXeSensitiveDetector::~muensterTPCLXeSensitiveDetector()
 
 void muensterTPCLXeSensitiveDetector::Initialize(G4HCofThisEvent* pHitsCollectionOfThisEvent)
 {
-	m_pLXeHitsCollection = new muensterTPCLXeHitsCollection(SensitiveDetectorName, collectionName[0]);
+	// the steps are kept by the sensitive detector, the arrays keep their memory
+	m_hHitStore.Clear();
+	m_bHasSecondaries = false;
+
+	// empty if the clustering is off
+	m_pLXeClustersCollection = new muensterTPCLXeClustersCollection(SensitiveDetectorName, collectionName[0]);
 
-	static G4int iHitsCollectionID = -1;
+	// one sensitive detector per thread, hence no function static
+	if(m_iClustersCollectionID < 0)
+		m_iClustersCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+	pHitsCollectionOfThisEvent->AddHitsCollection(m_iClustersCollectionID, m_pLXeClustersCollection);
 
-	if(iHitsCollectionID < 0)
-		iHitsCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-	
-	pHitsCollectionOfThisEvent->AddHitsCollection(iHitsCollectionID, m_pLXeHitsCollection);
+	// invalidates the tracks of the last event without touching the table
+	if(++m_iGeneration == std::numeric_limits<G4int>::max())
+	{
+		m_hTracks.clear();
+		m_iGeneration = 1;
+	}
 
-	m_hParticleTypes.clear();
+	m_hClusterCells.clear();
 }
 
 G4bool muensterTPCLXeSensitiveDetector::ProcessHits(G4Step* pStep, G4TouchableHistory *pHistory)
@@ -49,44 +78,213 @@ G4bool muensterTPCLXeSensitiveDetector::ProcessHits(G4Step* pStep, G4TouchableHi
 	G4double dEnergyDeposited = pStep->GetTotalEnergyDeposit();
 	G4Track *pTrack = pStep->GetTrack();
 
-	muensterTPCLXeHit* pHit = new muensterTPCLXeHit();
+	// optical photons are never written, they are rejected before anything else
+	if(pTrack->GetDefinition() == G4OpticalPhoton::Definition())
+	{
+		m_lNbSkippedOpticalPhotonSteps++;
+		return false;
+	}
 
-	pHit->SetTrackId(pTrack->GetTrackID());
+	// interactions without deposit (compton, photoabsorption) leave their energy to the secondaries
+	if(!pStep->GetSecondaryInCurrentStep()->empty())
+		m_bHasSecondaries = true;
 
-	if(!m_hParticleTypes.count(pTrack->GetTrackID()))
-		m_hParticleTypes[pTrack->GetTrackID()] = pTrack->GetDefinition()->GetParticleName();
+	// skipped steps still register the particle type as parent type of the secondaries
+	TrackInfo *pTrackInfo = FindTrack(pTrack->GetTrackID());
+	if(!pTrackInfo)
+		pTrackInfo = AddTrack(pTrack);
 
-	pHit->SetParentId(pTrack->GetParentID());
-	pHit->SetParticleType(pTrack->GetDefinition()->GetParticleName());
+	if(dEnergyDeposited <= m_dEnergyThreshold)
+	{
+		m_lNbSkippedEnergySteps++;
+		return false;
+	}
 
-	if(pTrack->GetParentID())
-		pHit->SetParentType(m_hParticleTypes[pTrack->GetParentID()]);
-	else
-		pHit->SetParentType(G4String("none"));
+	if(!IsParticleAccepted(pTrack->GetDefinition()))
+	{
+		m_lNbSkippedParticleSteps++;
+		return false;
+	}
 
-	if(pTrack->GetCreatorProcess())
-		pHit->SetCreatorProcess(pTrack->GetCreatorProcess()->GetProcessName());
-	else
-		pHit->SetCreatorProcess(G4String("Null"));
+	m_lNbStoredSteps++;
+
+	if(IsClustering())
+	{
+		AddToCluster(pTrack->GetTrackID(), pTrackInfo->iFamilyId, pTrackInfo->pParticleDefinition,
+			pStep->GetPostStepPoint()->GetPosition(), dEnergyDeposited, pTrack->GetGlobalTime());
+		return true;
+	}
 
-	pHit->SetDepositingProcess(pStep->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName());
-	pHit->SetPosition(pStep->GetPostStepPoint()->GetPosition());
-	pHit->SetEnergyDeposited(dEnergyDeposited);
-	pHit->SetKineticEnergy(pTrack->GetKineticEnergy());
-	pHit->SetTime(pTrack->GetGlobalTime());
+	// no parent: primary or the parent did not reach the sensitive volume
+	TrackInfo *pParentInfo = FindTrack(pTrack->GetParentID());
+	const G4ParticleDefinition *pParentDefinition = (pParentInfo)?(pParentInfo->pParticleDefinition):(0);
 
-	m_pLXeHitsCollection->insert(pHit);
+	// no creator process: primary (Null)
+	m_hHitStore.AddHit(pTrack->GetTrackID(), pTrack->GetParentID(), pTrackInfo->pParticleDefinition, pParentDefinition,
+		pTrackInfo->pCreatorProcess, pStep->GetPostStepPoint()->GetProcessDefinedStep(), pStep->GetPostStepPoint()->GetPosition(),
+		dEnergyDeposited, pTrack->GetKineticEnergy(), pTrack->GetGlobalTime());
 
 	return true;
 }
 
 void muensterTPCLXeSensitiveDetector::EndOfEvent(G4HCofThisEvent *pHitsCollectionOfThisEvent)
 {
-//  if (verboseLevel>0) { 
-//     G4int NbHits = m_pLXeHitsCollection->entries();
-//     G4cout << "\n-------->Hits Collection: in this event they are " << NbHits 
-//            << " hits in the tracker chambers: " << G4endl;
-//     for (G4int i=0;i<NbHits;i++) (*m_pLXeHitsCollection)[i]->Print();
-//    } 
 }
 
+//******************************************************************/
+// first step of a track in this event, the table grows with the
+// largest track id
+//******************************************************************/
+muensterTPCLXeSensitiveDetector::TrackInfo *muensterTPCLXeSensitiveDetector::AddTrack(const G4Track *pTrack)
+{
+	G4int iTrackId = pTrack->GetTrackID();
+	if(iTrackId >= (G4int) m_hTracks.size())
+	{
+		TrackInfo hEmptyTrack = {0, 0, 0, 0};
+		m_hTracks.resize(std::max(iTrackId+1, 2*(G4int) m_hTracks.size()), hEmptyTrack);
+	}
+
+	TrackInfo *pTrackInfo = &m_hTracks[iTrackId];
+	pTrackInfo->iGeneration = m_iGeneration;
+	pTrackInfo->pParticleDefinition = pTrack->GetDefinition();
+	pTrackInfo->pCreatorProcess = pTrack->GetCreatorProcess();
+
+	// the family of the parent, or a new family (primaries, parents outside of the sensitive volume)
+	TrackInfo *pParentInfo = FindTrack(pTrack->GetParentID());
+	if(pParentInfo)
+		pTrackInfo->iFamilyId = pParentInfo->iFamilyId;
+	else
+		pTrackInfo->iFamilyId = (pTrack->GetParentID())?(pTrack->GetParentID()):(iTrackId);
+
+	return pTrackInfo;
+}
+
+//******************************************************************/
+// particle whitelist, resolved once per particle definition
+//******************************************************************/
+G4bool muensterTPCLXeSensitiveDetector::IsParticleAccepted(const G4ParticleDefinition *pParticleDefinition)
+{
+	if(m_hParticleNames.empty())
+		return true;
+
+	// the whitelist was changed between two runs
+	if(m_hAcceptedParticleNames != m_hParticleNames)
+	{
+		m_hAcceptedParticles.clear();
+		m_hAcceptedParticleNames = m_hParticleNames;
+	}
+
+	map<const G4ParticleDefinition *, G4bool>::iterator pIt = m_hAcceptedParticles.find(pParticleDefinition);
+	if(pIt != m_hAcceptedParticles.end())
+		return pIt->second;
+
+	G4bool bAccepted = (m_hParticleNames.count(pParticleDefinition->GetParticleName()) > 0)
+		|| (m_hParticleNames.count("ions") > 0 && pParticleDefinition->GetParticleType() == "nucleus");
+	m_hAcceptedParticles[pParticleDefinition] = bAccepted;
+
+	return bAccepted;
+}
+
+void muensterTPCLXeSensitiveDetector::SetParticles(const G4String &hParticleNames)
+{
+	m_hParticleNames.clear();
+
+	G4Tokenizer next(hParticleNames);
+	for(G4String hParticleName = next(); !hParticleName.empty(); hParticleName = next())
+	{
+		if(hParticleName != "all")
+			m_hParticleNames.insert(hParticleName);
+	}
+}
+
+//******************************************************************/
+// merge the deposit into the closest cluster of the same family within
+// the distance and time window, only the 27 cells around the deposit
+// are searched (cell size = distance)
+//******************************************************************/
+void muensterTPCLXeSensitiveDetector::AddToCluster(G4int iTrackId, G4int iFamilyId, const G4ParticleDefinition *pParticleDefinition,
+	const G4ThreeVector &hPosition, G4double dEnergyDeposited, G4double dTime)
+{
+	G4int iBestCluster = -1;
+	G4double dBestDistance2 = m_dClusterDistance*m_dClusterDistance;
+
+	for(G4int iOffsetX=-1; iOffsetX<=1; iOffsetX++)
+	for(G4int iOffsetY=-1; iOffsetY<=1; iOffsetY++)
+	for(G4int iOffsetZ=-1; iOffsetZ<=1; iOffsetZ++)
+	{
+		unordered_map<G4long, vector<G4int> >::iterator pCell = m_hClusterCells.find(GetClusterCell(hPosition, iOffsetX, iOffsetY, iOffsetZ));
+		if(pCell == m_hClusterCells.end())
+			continue;
+
+		for(size_t i=0; i<pCell->second.size(); i++)
+		{
+			muensterTPCLXeCluster *pCluster = (*m_pLXeClustersCollection)[pCell->second[i]];
+			if(pCluster->GetFamilyId() != iFamilyId || std::fabs(pCluster->GetTime()-dTime) > m_dClusterTime)
+				continue;
+
+			G4double dDistance2 = (pCluster->GetPosition()-hPosition).mag2();
+			if(dDistance2 <= dBestDistance2)
+			{
+				iBestCluster = pCell->second[i];
+				dBestDistance2 = dDistance2;
+			}
+		}
+	}
+
+	if(iBestCluster < 0)
+	{
+		muensterTPCLXeCluster *pCluster = new muensterTPCLXeCluster();
+		pCluster->SetTrackId(iTrackId);
+		pCluster->SetFamilyId(iFamilyId);
+		pCluster->SetParticleDefinition(pParticleDefinition);
+		pCluster->AddDeposit(hPosition, dEnergyDeposited, dTime);
+
+		iBestCluster = m_pLXeClustersCollection->insert(pCluster)-1;
+		m_hClusterCells[GetClusterCell(hPosition)].push_back(iBestCluster);
+		m_lNbClusters++;
+		return;
+	}
+
+	// the cluster moves to another cell if its position crosses the cell border
+	muensterTPCLXeCluster *pCluster = (*m_pLXeClustersCollection)[iBestCluster];
+	G4long lOldCell = GetClusterCell(pCluster->GetPosition());
+	pCluster->AddDeposit(hPosition, dEnergyDeposited, dTime);
+	G4long lNewCell = GetClusterCell(pCluster->GetPosition());
+
+	if(lNewCell != lOldCell)
+	{
+		vector<G4int> &hOldCell = m_hClusterCells[lOldCell];
+		hOldCell.erase(std::find(hOldCell.begin(), hOldCell.end(), iBestCluster));
+		m_hClusterCells[lNewCell].push_back(iBestCluster);
+	}
+}
+
+G4long muensterTPCLXeSensitiveDetector::GetClusterCell(const G4ThreeVector &hPosition, G4int iOffsetX, G4int iOffsetY, G4int iOffsetZ)
+{
+	// 21 bits per coordinate
+	G4long lX = (G4long) std::floor(hPosition.x()/m_dClusterDistance) + iOffsetX + (1L<<20);
+	G4long lY = (G4long) std::floor(hPosition.y()/m_dClusterDistance) + iOffsetY + (1L<<20);
+	G4long lZ = (G4long) std::floor(hPosition.z()/m_dClusterDistance) + iOffsetZ + (1L<<20);
+
+	return (lX << 42) | (lY << 21) | lZ;
+}
+
+void muensterTPCLXeSensitiveDetector::ResetStatistics()
+{
+	m_lNbClusters = 0;
+	m_lNbStoredSteps = 0;
+	m_lNbSkippedOpticalPhotonSteps = 0;
+	m_lNbSkippedEnergySteps = 0;
+	m_lNbSkippedParticleSteps = 0;
+}
+
+void muensterTPCLXeSensitiveDetector::PrintStatistics()
+{
+	G4cout << "LXe sensitive detector: " << m_lNbStoredSteps << " steps stored, skipped "
+		<< m_lNbSkippedOpticalPhotonSteps << " optical photon steps, "
+		<< m_lNbSkippedEnergySteps << " steps with energy deposit <= " << m_dEnergyThreshold/keV << " keV, "
+		<< m_lNbSkippedParticleSteps << " steps of other particles" << G4endl;
+
+	if(IsClustering())
+		G4cout << "LXe sensitive detector: " << m_lNbStoredSteps << " steps merged into " << m_lNbClusters << " clusters" << G4endl;
+}
@@ -0,0 +1,223 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include <G4SystemOfUnits.hh>
+
+#include <cmath>
+
+#include <TH3D.h>
+#include <TString.h>
+#include <TDirectory.h>
+#include <TParameter.h>
+
+#include "muensterTPCLceMap.hh"
+
+muensterTPCLceMap::muensterTPCLceMap()
+{
+	m_hCoordinates = "off";
+
+	// active volume (z: -2<>-169|r: 0<>40)
+	SetBins(20, 36, 34);
+	SetRange(0., 40., -180., 180., -169., -2.);
+
+	m_iNbTopPmts = 0;
+	m_iNbBottomPmts = 0;
+
+	m_pEmitted = 0;
+}
+
+muensterTPCLceMap::~muensterTPCLceMap()
+{
+	Reset();
+}
+
+void muensterTPCLceMap::SetBins(G4int iNbBins1, G4int iNbBins2, G4int iNbBins3)
+{
+	m_iNbBins[0] = iNbBins1;
+	m_iNbBins[1] = iNbBins2;
+	m_iNbBins[2] = iNbBins3;
+}
+
+void muensterTPCLceMap::SetRange(G4double dMin1, G4double dMax1, G4double dMin2, G4double dMax2, G4double dMin3, G4double dMax3)
+{
+	m_dMin[0] = dMin1; m_dMax[0] = dMax1;
+	m_dMin[1] = dMin2; m_dMax[1] = dMax2;
+	m_dMin[2] = dMin3; m_dMax[2] = dMax3;
+}
+
+//******************************************************************/
+// create the histograms of this run, they are not attached to the
+// output file and stay in memory until Write
+//******************************************************************/
+void muensterTPCLceMap::Initialize(G4int iNbTopPmts, G4int iNbBottomPmts, G4int iNbPmts)
+{
+	Reset();
+
+	m_iNbTopPmts = iNbTopPmts;
+	m_iNbBottomPmts = iNbBottomPmts;
+
+	G4String hAxes = (m_hCoordinates == "xyz")?(";x [mm];y [mm];z [mm]"):(";r [mm];phi [deg];z [mm]");
+
+	m_pEmitted = new TH3D("emitted", ("emitted photons" + hAxes).c_str(),
+		m_iNbBins[0], m_dMin[0], m_dMax[0], m_iNbBins[1], m_dMin[1], m_dMax[1], m_iNbBins[2], m_dMin[2], m_dMax[2]);
+	m_pEmitted->SetDirectory(0);
+
+	for(G4int iPmtNb=0; iPmtNb<iNbPmts; iPmtNb++)
+	{
+		TH3D *pDetected = (TH3D *) m_pEmitted->Clone(Form("detected_%d", iPmtNb));
+		pDetected->SetTitle(Form("detected photons pmt %d%s", iPmtNb, hAxes.c_str()));
+		pDetected->SetDirectory(0);
+		m_hDetected.push_back(pDetected);
+	}
+}
+
+//******************************************************************/
+// one bin lookup per event, the hits of each pmt are added to the
+// bin of the emission position
+//******************************************************************/
+void muensterTPCLceMap::Fill(const G4ThreeVector &hPosition, G4int iNbEmitted, const vector<G4int> &hHitPmts, const vector<G4int> &hPmtCounts)
+{
+	if(!m_pEmitted)
+		return;
+
+	G4int iBin = 0;
+	if(m_hCoordinates == "xyz")
+		iBin = m_pEmitted->FindBin(hPosition.x()/mm, hPosition.y()/mm, hPosition.z()/mm);
+	else
+		iBin = m_pEmitted->FindBin(hPosition.perp()/mm, hPosition.phi()/deg, hPosition.z()/mm);
+
+	m_pEmitted->AddBinContent(iBin, iNbEmitted);
+
+	for(size_t i=0; i<hHitPmts.size(); i++)
+	{
+		G4int iPmtNb = hHitPmts[i];
+		if(iPmtNb >= 0 && iPmtNb < (G4int) m_hDetected.size())
+			m_hDetected[iPmtNb]->AddBinContent(iBin, hPmtCounts[iPmtNb]);
+	}
+}
+
+//******************************************************************/
+// write the counts and the maps into pDirectory/lce
+//******************************************************************/
+void muensterTPCLceMap::Write(TDirectory *pDirectory)
+{
+	if(!m_pEmitted)
+		return;
+
+	TDirectory *pLceDirectory = pDirectory->GetDirectory("lce");
+	if(!pLceDirectory)
+		pLceDirectory = pDirectory->mkdir("lce");
+	pLceDirectory->cd();
+
+	// AddBinContent does not count the entries
+	m_pEmitted->SetEntries(m_pEmitted->GetSumOfWeights());
+	m_pEmitted->Write(0, TObject::kOverwrite);
+	for(size_t i=0; i<m_hDetected.size(); i++)
+	{
+		m_hDetected[i]->SetEntries(m_hDetected[i]->GetSumOfWeights());
+		m_hDetected[i]->Write(0, TObject::kOverwrite);
+	}
+
+	// the same in all merged files
+	TParameter<int> hNbTopPmtsParameter("nbtoppmts", m_iNbTopPmts);
+	hNbTopPmtsParameter.SetMergeMode('M');
+	hNbTopPmtsParameter.Write(0, TObject::kOverwrite);
+	TParameter<int> hNbBottomPmtsParameter("nbbottompmts", m_iNbBottomPmts);
+	hNbBottomPmtsParameter.SetMergeMode('M');
+	hNbBottomPmtsParameter.Write(0, TObject::kOverwrite);
+	TParameter<int> hCartesianParameter("cartesian", (m_hCoordinates == "xyz")?(1):(0));
+	hCartesianParameter.SetMergeMode('M');
+	hCartesianParameter.Write(0, TObject::kOverwrite);
+
+	UpdateMaps(pDirectory);
+}
+
+//******************************************************************/
+// (re)compute the maps from the counts in pDirectory/lce, the maps
+// of merged files are sums and have to be computed again
+//******************************************************************/
+void muensterTPCLceMap::UpdateMaps(TDirectory *pDirectory)
+{
+	TDirectory *pLceDirectory = pDirectory->GetDirectory("lce");
+	if(!pLceDirectory)
+		return;
+
+	TH3D *pEmitted = (TH3D *) pLceDirectory->Get("emitted");
+	TParameter<int> *pNbTopPmts = (TParameter<int> *) pLceDirectory->Get("nbtoppmts");
+	TParameter<int> *pNbBottomPmts = (TParameter<int> *) pLceDirectory->Get("nbbottompmts");
+	if(!pEmitted || !pNbTopPmts || !pNbBottomPmts)
+		return;
+
+	pEmitted->SetDirectory(0);
+	G4int iNbTopPmts = pNbTopPmts->GetVal();
+	G4int iNbBottomPmts = pNbBottomPmts->GetVal();
+
+	TH3D *pTop = (TH3D *) pEmitted->Clone("lce_top");
+	TH3D *pBottom = (TH3D *) pEmitted->Clone("lce_bottom");
+	TH3D *pTotal = (TH3D *) pEmitted->Clone("lce_total");
+	pTop->Reset(); pBottom->Reset(); pTotal->Reset();
+
+	vector<TH3D *> hMaps;
+	for(G4int iPmtNb=0; ; iPmtNb++)
+	{
+		TH3D *pDetected = (TH3D *) pLceDirectory->Get(Form("detected_%d", iPmtNb));
+		if(!pDetected)
+			break;
+
+		pDetected->SetDirectory(0);
+		pDetected->SetName(Form("lce_%d", iPmtNb));
+		pDetected->SetTitle(Form("light collection efficiency pmt %d", iPmtNb));
+
+		if(iPmtNb < iNbTopPmts)
+			pTop->Add(pDetected);
+		else if(iPmtNb < iNbTopPmts+iNbBottomPmts)
+			pBottom->Add(pDetected);
+		pTotal->Add(pDetected);
+
+		hMaps.push_back(pDetected);
+	}
+	pTop->SetTitle("light collection efficiency top pmts");
+	pBottom->SetTitle("light collection efficiency bottom pmts");
+	pTotal->SetTitle("light collection efficiency all pmts");
+	hMaps.push_back(pTop);
+	hMaps.push_back(pBottom);
+	hMaps.push_back(pTotal);
+
+	// lce = detected/emitted, binomial uncertainty sqrt(lce*(1-lce)/emitted)
+	pLceDirectory->cd();
+	for(size_t i=0; i<hMaps.size(); i++)
+	{
+		TH3D *pMap = hMaps[i];
+		for(G4int iBin=0; iBin<pMap->GetNcells(); iBin++)
+		{
+			G4double dEmitted = pEmitted->GetBinContent(iBin);
+			G4double dLce = (dEmitted > 0.)?(pMap->GetBinContent(iBin)/dEmitted):(0.);
+			G4double dLceError = (dEmitted > 0.)?(std::sqrt(dLce*(1.-dLce)/dEmitted)):(0.);
+
+			pMap->SetBinContent(iBin, dLce);
+			pMap->SetBinError(iBin, dLceError);
+		}
+		pMap->SetEntries(pEmitted->GetEntries());
+		pMap->Write(0, TObject::kOverwrite);
+		delete pMap;
+	}
+
+	delete pEmitted;
+	delete pNbTopPmts;
+	delete pNbBottomPmts;
+}
+
+void muensterTPCLceMap::Reset()
+{
+	delete m_pEmitted;
+	m_pEmitted = 0;
+
+	for(size_t i=0; i<m_hDetected.size(); i++)
+		delete m_hDetected[i];
+	m_hDetected.clear();
+}
+
@@ -0,0 +1,698 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include <G4SystemOfUnits.hh>
+#include <G4PhysicalConstants.hh>
+#include <G4Region.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+#include <G4MaterialPropertiesTable.hh>
+#include <G4LogicalBorderSurface.hh>
+#include <G4OpticalSurface.hh>
+#include <G4Tubs.hh>
+#include <G4Box.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4SDManager.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4RandomDirection.hh>
+#include <Randomize.hh>
+#include <G4ios.hh>
+
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "muensterTPCOpticalRayTracer.hh"
+#include "muensterTPCPmtSensitiveDetector.hh"
+
+G4bool muensterTPCOpticalRayTracer::m_bEnabled = false;
+G4int muensterTPCOpticalRayTracer::m_iBatchSize = 1024;
+G4ThreadLocal muensterTPCOpticalRayTracer *muensterTPCOpticalRayTracer::m_pInstance = 0;
+
+// photons on a surface only see the surfaces in front of them
+static const G4double s_dTolerance = 1.e-9*mm;
+// photons still alive after this many interactions of a batch are dropped
+static const G4int s_iMaxIterations = 100000;
+
+muensterTPCOpticalRayTracer::muensterTPCOpticalRayTracer(const G4String &hName, G4Region *pRegion): G4VFastSimulationModel(hName, pRegion)
+{
+	m_bModelValid = false;
+	m_pPmtSD = 0;
+
+	m_dRadius = 0.;
+	m_dBottomZ = 0.;
+	m_dTopZ = 0.;
+	m_dLiquidZ = 0.;
+
+	m_dPmtWindowHalfWidth = 0.;
+	m_dPmtPhotoCathodeHalfWidth = 0.;
+	m_pWindowRefractiveIndex = 0;
+
+	m_iNbPhotons = 0;
+
+	m_lNbPhotons = 0;
+	m_lNbDetected = 0;
+	m_lNbBulkAbsorbed = 0;
+	m_lNbSurfaceAbsorbed = 0;
+	m_lNbLost = 0;
+
+	m_pInstance = this;
+}
+
+muensterTPCOpticalRayTracer::~muensterTPCOpticalRayTracer()
+{
+	if(m_pInstance == this)
+		m_pInstance = 0;
+}
+
+G4bool muensterTPCOpticalRayTracer::IsApplicable(const G4ParticleDefinition &hParticleDefinition)
+{
+	return &hParticleDefinition == G4OpticalPhoton::Definition();
+}
+
+//******************************************************************/
+// photons inside the ptfe cylinder, the others are tracked by Geant4
+//******************************************************************/
+G4bool muensterTPCOpticalRayTracer::ModelTrigger(const G4FastTrack &hFastTrack)
+{
+	if(!m_bModelValid)
+		return false;
+
+	const G4ThreeVector &hPosition = hFastTrack.GetPrimaryTrack()->GetPosition();
+
+	return hPosition.perp2() < m_dRadius*m_dRadius && hPosition.z() > m_dBottomZ && hPosition.z() < m_dTopZ;
+}
+
+void muensterTPCOpticalRayTracer::DoIt(const G4FastTrack &hFastTrack, G4FastStep &hFastStep)
+{
+	const G4Track *pTrack = hFastTrack.GetPrimaryTrack();
+
+	hFastStep.KillPrimaryTrack();
+	hFastStep.ProposePrimaryTrackPathLength(0.);
+
+	G4int i = m_iNbPhotons++;
+	m_hX[i] = pTrack->GetPosition().x();
+	m_hY[i] = pTrack->GetPosition().y();
+	m_hZ[i] = pTrack->GetPosition().z();
+	m_hDx[i] = pTrack->GetMomentumDirection().x();
+	m_hDy[i] = pTrack->GetMomentumDirection().y();
+	m_hDz[i] = pTrack->GetMomentumDirection().z();
+	m_hTime[i] = pTrack->GetGlobalTime();
+	m_hEnergy[i] = pTrack->GetTotalEnergy();
+
+	for(G4int iMedium=0; iMedium<2; iMedium++)
+	{
+		const MediumModel &hMedium = m_hMedia[iMedium];
+		m_hAttenuation[iMedium][i] = 1./GetValue(hMedium.pAbsorptionLength, m_hEnergy[i], DBL_MAX)
+			+ 1./GetValue(hMedium.pRayleighLength, m_hEnergy[i], DBL_MAX);
+		m_hIndex[iMedium][i] = GetValue(hMedium.pRefractiveIndex, m_hEnergy[i], 1.);
+		m_hGroupIndex[iMedium][i] = GetGroupIndex(hMedium.pRefractiveIndex, m_hEnergy[i]);
+	}
+
+	m_lNbPhotons++;
+
+	if(m_iNbPhotons == m_iBatchSize)
+		TraceBatch();
+}
+
+//******************************************************************/
+// analytic model and batch buffers of this run
+//******************************************************************/
+void muensterTPCOpticalRayTracer::Initialize()
+{
+	m_pPmtSD = dynamic_cast<muensterTPCPmtSensitiveDetector *>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("muensterTPC/PmtSD", false));
+
+	m_bModelValid = BuildModel();
+	if(!m_bModelValid)
+		G4cout << "!!!!> optical ray tracer: the TPC volumes were not found, the photons are tracked." << G4endl;
+
+	vector<G4double> *pArrays[] = {&m_hX, &m_hY, &m_hZ, &m_hDx, &m_hDy, &m_hDz, &m_hTime, &m_hEnergy,
+		&m_hAttenuation[0], &m_hAttenuation[1], &m_hIndex[0], &m_hIndex[1], &m_hGroupIndex[0], &m_hGroupIndex[1], &m_hRandom, &m_hInvDz, &m_hStep};
+	for(size_t i=0; i<sizeof(pArrays)/sizeof(pArrays[0]); i++)
+		pArrays[i]->assign(m_iBatchSize, 0.);
+	m_hInteraction.assign(m_iBatchSize, BULK);
+	m_hPlane.assign(m_iBatchSize, -1);
+
+	m_iNbPhotons = 0;
+
+	m_lNbPhotons = 0;
+	m_lNbDetected = 0;
+	m_lNbBulkAbsorbed = 0;
+	m_lNbSurfaceAbsorbed = 0;
+	m_lNbLost = 0;
+}
+
+//******************************************************************/
+// global centres of all placements below pMother
+//******************************************************************/
+void muensterTPCOpticalRayTracer::FindPlacements(G4VPhysicalVolume *pMother, const G4ThreeVector &hPosition, const G4RotationMatrix &hRotation, vector<Placement> &hPlacements)
+{
+	G4LogicalVolume *pLogicalVolume = pMother->GetLogicalVolume();
+	for(G4int i=0; i<pLogicalVolume->GetNoDaughters(); i++)
+	{
+		G4VPhysicalVolume *pDaughter = pLogicalVolume->GetDaughter(i);
+
+		Placement hPlacement;
+		hPlacement.pVolume = pDaughter;
+		hPlacement.pMother = pMother;
+		hPlacement.hPosition = hPosition + hRotation*pDaughter->GetTranslation();
+		hPlacements.push_back(hPlacement);
+
+		FindPlacements(pDaughter, hPlacement.hPosition, hRotation*pDaughter->GetObjectRotationValue(), hPlacements);
+	}
+}
+
+//******************************************************************/
+// cylinder: inner radius of the PTFEInnerCylinder between the pmt
+// holders, liquid surface: bottom of the GXe, meshes: LXe/GXeGridMesh,
+// pmts: PmtWindowNo<pmt> and PmtPhotoCathode, the optical parameters
+// from the materials and the teflon border surfaces
+//******************************************************************/
+G4bool muensterTPCOpticalRayTracer::BuildModel()
+{
+	G4VPhysicalVolume *pWorld = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume();
+	if(!pWorld)
+		return false;
+
+	vector<Placement> hPlacements;
+	FindPlacements(pWorld, pWorld->GetTranslation(), pWorld->GetObjectRotationValue(), hPlacements);
+
+	const Placement *pCylinder = 0, *pGXe = 0, *pBottomHolder = 0, *pTopHolder = 0, *pTopSlab = 0;
+	G4Box *pWindowBox = 0, *pPhotoCathodeBox = 0;
+	vector<const Placement *> hMeshes;
+	vector<G4double> hPmtZ;
+
+	m_hPmtX.clear();
+	m_hPmtY.clear();
+	m_hPmtNb.clear();
+	m_hPmtTop.clear();
+	m_pWindowRefractiveIndex = 0;
+
+	for(size_t i=0; i<hPlacements.size(); i++)
+	{
+		const Placement &hPlacement = hPlacements[i];
+		const G4String &hName = hPlacement.pVolume->GetName();
+
+		if(hName == "PTFEInnerCylinder")
+			pCylinder = &hPlacement;
+		else if(hName == "GXe")
+			pGXe = &hPlacement;
+		else if(hName == "PTFEBottomPMTHolder")
+			pBottomHolder = &hPlacement;
+		else if(hName == "PTFETopPMTHolder")
+			pTopHolder = &hPlacement;
+		else if(hName == "TopPTFESlab")
+			pTopSlab = &hPlacement;
+		else if(hName == "LXeGridMesh" || hName == "GXeGridMesh")
+			hMeshes.push_back(&hPlacement);
+		else if(hName == "PmtPhotoCathode")
+			pPhotoCathodeBox = dynamic_cast<G4Box *>(hPlacement.pVolume->GetLogicalVolume()->GetSolid());
+		else if(hName.compare(0, 11, "PmtWindowNo") == 0)
+		{
+			pWindowBox = dynamic_cast<G4Box *>(hPlacement.pVolume->GetLogicalVolume()->GetSolid());
+			m_hPmtX.push_back(hPlacement.hPosition.x());
+			m_hPmtY.push_back(hPlacement.hPosition.y());
+			m_hPmtNb.push_back(hPlacement.pVolume->GetCopyNo());
+			hPmtZ.push_back(hPlacement.hPosition.z());
+
+			G4MaterialPropertiesTable *pTable = hPlacement.pVolume->GetLogicalVolume()->GetMaterial()->GetMaterialPropertiesTable();
+			m_pWindowRefractiveIndex = (pTable)?(pTable->GetProperty("RINDEX")):(0);
+		}
+	}
+
+	G4Tubs *pCylinderTubs = (pCylinder)?(dynamic_cast<G4Tubs *>(pCylinder->pVolume->GetLogicalVolume()->GetSolid())):(0);
+	G4Tubs *pGXeTubs = (pGXe)?(dynamic_cast<G4Tubs *>(pGXe->pVolume->GetLogicalVolume()->GetSolid())):(0);
+	G4Tubs *pBottomHolderTubs = (pBottomHolder)?(dynamic_cast<G4Tubs *>(pBottomHolder->pVolume->GetLogicalVolume()->GetSolid())):(0);
+	G4Tubs *pTopHolderTubs = (pTopHolder)?(dynamic_cast<G4Tubs *>(pTopHolder->pVolume->GetLogicalVolume()->GetSolid())):(0);
+
+	if(!pCylinderTubs || !pGXeTubs || !pBottomHolderTubs || !pTopHolderTubs || !pWindowBox || !pPhotoCathodeBox)
+		return false;
+
+	m_dRadius = pCylinderTubs->GetInnerRadius();
+	m_dBottomZ = pBottomHolder->hPosition.z()+pBottomHolderTubs->GetZHalfLength();
+	m_dTopZ = pTopHolder->hPosition.z()-pTopHolderTubs->GetZHalfLength();
+	m_dLiquidZ = pGXe->hPosition.z()-pGXeTubs->GetZHalfLength();
+
+	m_dPmtWindowHalfWidth = pWindowBox->GetXHalfLength();
+	m_dPmtPhotoCathodeHalfWidth = pPhotoCathodeBox->GetXHalfLength();
+
+	// the top array is in the gas
+	for(size_t i=0; i<hPmtZ.size(); i++)
+		m_hPmtTop.push_back(hPmtZ[i] > m_dLiquidZ);
+
+	m_hPlaneZ.clear();
+	m_hPlaneType.clear();
+	m_hPlaneAbsorptionLength.clear();
+	m_hPlaneThickness.clear();
+
+	G4double pdPlaneZ[] = {m_dBottomZ, m_dTopZ, m_dLiquidZ};
+	G4int piPlaneType[] = {PLANE_BOTTOM, PLANE_TOP, PLANE_LIQUID};
+	for(G4int i=0; i<3; i++)
+	{
+		m_hPlaneZ.push_back(pdPlaneZ[i]);
+		m_hPlaneType.push_back(piPlaneType[i]);
+		m_hPlaneAbsorptionLength.push_back(0);
+		m_hPlaneThickness.push_back(0.);
+	}
+
+	// the transparency of the meshes is given by the absorption length of their material
+	for(size_t i=0; i<hMeshes.size(); i++)
+	{
+		G4Tubs *pMeshTubs = dynamic_cast<G4Tubs *>(hMeshes[i]->pVolume->GetLogicalVolume()->GetSolid());
+		G4double dZ = hMeshes[i]->hPosition.z();
+		if(!pMeshTubs || dZ <= m_dBottomZ || dZ >= m_dTopZ)
+			continue;
+
+		G4MaterialPropertiesTable *pTable = hMeshes[i]->pVolume->GetLogicalVolume()->GetMaterial()->GetMaterialPropertiesTable();
+		m_hPlaneZ.push_back(dZ);
+		m_hPlaneType.push_back(PLANE_MESH);
+		m_hPlaneAbsorptionLength.push_back((pTable)?(pTable->GetProperty("ABSLENGTH")):(0));
+		m_hPlaneThickness.push_back(2.*pMeshTubs->GetZHalfLength());
+	}
+
+	// the liquid is the mother of the GXe (see /Xe/detector/setMaterial)
+	G4Material *pMaterials[2] = {pGXe->pMother->GetLogicalVolume()->GetMaterial(), pGXe->pVolume->GetLogicalVolume()->GetMaterial()};
+	for(G4int i=0; i<2; i++)
+	{
+		G4MaterialPropertiesTable *pTable = pMaterials[i]->GetMaterialPropertiesTable();
+		m_hMedia[i].pRefractiveIndex = (pTable)?(pTable->GetProperty("RINDEX")):(0);
+		m_hMedia[i].pAbsorptionLength = (pTable)?(pTable->GetProperty("ABSLENGTH")):(0);
+		m_hMedia[i].pRayleighLength = (pTable)?(pTable->GetProperty("RAYLEIGH")):(0);
+	}
+
+	// TeflonOpticalSurface in the liquid and GXeTeflonOpticalSurface in the gas, absorbing without surface
+	const Placement *pWalls[2] = {pCylinder, pTopSlab};
+	for(G4int i=0; i<2; i++)
+	{
+		G4LogicalBorderSurface *pBorderSurface = (pWalls[i])?(G4LogicalBorderSurface::GetSurface(pWalls[i]->pMother, pWalls[i]->pVolume)):(0);
+		G4OpticalSurface *pSurface = (pBorderSurface)?(dynamic_cast<G4OpticalSurface *>(pBorderSurface->GetSurfaceProperty())):(0);
+		G4MaterialPropertiesTable *pTable = (pSurface)?(pSurface->GetMaterialPropertiesTable()):(0);
+
+		if(!pTable)
+			G4cout << "!!!!> optical ray tracer: no teflon surface in the " << ((i)?("gas"):("liquid")) << ", the wall is absorbing." << G4endl;
+
+		m_hSurfaces[i].pReflectivity = (pTable)?(pTable->GetProperty("REFLECTIVITY")):(0);
+		m_hSurfaces[i].pSpecularLobe = (pTable)?(pTable->GetProperty("SPECULARLOBECONSTANT")):(0);
+		m_hSurfaces[i].pSpecularSpike = (pTable)?(pTable->GetProperty("SPECULARSPIKECONSTANT")):(0);
+		m_hSurfaces[i].pBackscatter = (pTable)?(pTable->GetProperty("BACKSCATTERCONSTANT")):(0);
+		m_hSurfaces[i].dSigmaAlpha = (pSurface)?(pSurface->GetSigmaAlpha()):(0.);
+	}
+
+	G4cout << "Optical ray tracer: r < " << m_dRadius/mm << " mm, z " << m_dBottomZ/mm << " to " << m_dTopZ/mm
+		<< " mm, liquid surface " << m_dLiquidZ/mm << " mm, " << m_hPlaneZ.size()-3 << " meshes, " << m_hPmtNb.size() << " pmts" << G4endl;
+
+	return true;
+}
+
+//******************************************************************/
+// interactions of all photons of the batch until they are detected
+// or absorbed, the survivors are moved to the front of the arrays
+//******************************************************************/
+void muensterTPCOpticalRayTracer::TraceBatch()
+{
+	G4int iNbPhotons = m_iNbPhotons;
+	for(G4int iIteration=0; iNbPhotons > 0; iIteration++)
+	{
+		if(iIteration == s_iMaxIterations)
+		{
+			m_lNbLost += iNbPhotons;
+			break;
+		}
+
+		ComputeSteps(iNbPhotons);
+
+		G4int iNbAlive = 0;
+		for(G4int i=0; i<iNbPhotons; i++)
+		{
+			if(Interact(i) != ALIVE)
+				continue;
+
+			if(i != iNbAlive)
+				CopyPhoton(i, iNbAlive);
+			iNbAlive++;
+		}
+		iNbPhotons = iNbAlive;
+	}
+
+	m_iNbPhotons = 0;
+}
+
+//******************************************************************/
+// distance to the next interaction of every photon: bulk (sampled),
+// wall (ray-cylinder) or horizontal surface (ray-plane), then all
+// photons are moved there; the loops have no dependencies between
+// the photons and no function calls besides log/sqrt
+//******************************************************************/
+void muensterTPCOpticalRayTracer::ComputeSteps(G4int iNbPhotons)
+{
+	CLHEP::HepRandom::getTheEngine()->flatArray(iNbPhotons, &m_hRandom[0]);
+
+	G4double *pX = &m_hX[0], *pY = &m_hY[0], *pZ = &m_hZ[0];
+	G4double *pDx = &m_hDx[0], *pDy = &m_hDy[0], *pDz = &m_hDz[0];
+	G4double *pTime = &m_hTime[0];
+	const G4double *pAttenuationLXe = &m_hAttenuation[0][0], *pAttenuationGXe = &m_hAttenuation[1][0];
+	const G4double *pGroupIndexLXe = &m_hGroupIndex[0][0], *pGroupIndexGXe = &m_hGroupIndex[1][0];
+	const G4double *pRandom = &m_hRandom[0];
+	G4double *pInvDz = &m_hInvDz[0];
+	G4double *pStep = &m_hStep[0];
+	G4int *pInteraction = &m_hInteraction[0];
+	G4int *pPlane = &m_hPlane[0];
+
+	const G4double dRadius2 = m_dRadius*m_dRadius;
+	const G4double dLiquidZ = m_dLiquidZ;
+
+	// bulk and ray-cylinder (largest root of |p+s*d|^2 = r^2 in the xy plane)
+	for(G4int i=0; i<iNbPhotons; i++)
+	{
+		G4bool bGas = pZ[i]+s_dTolerance*pDz[i] > dLiquidZ;
+		G4double dAttenuation = (bGas)?(pAttenuationGXe[i]):(pAttenuationLXe[i]);
+		G4double dBulk = -std::log(std::max(pRandom[i], DBL_MIN))/dAttenuation;
+
+		G4double dA = pDx[i]*pDx[i]+pDy[i]*pDy[i];
+		G4double dB = pX[i]*pDx[i]+pY[i]*pDy[i];
+		G4double dC = pX[i]*pX[i]+pY[i]*pY[i]-dRadius2;
+		G4double dWall = (-dB+std::sqrt(std::max(dB*dB-dA*dC, 0.)))/std::max(dA, DBL_MIN);
+		// vertical photons never reach the wall
+		dWall = (dA > 0.)?(std::max(dWall, 0.)):(DBL_MAX);
+
+		pStep[i] = std::min(dBulk, dWall);
+		pInteraction[i] = (dWall < dBulk)?((G4int) WALL):((G4int) BULK);
+		pPlane[i] = -1;
+		pInvDz[i] = 1./((pDz[i] != 0.)?(pDz[i]):(DBL_MIN));
+	}
+
+	// ray-plane, one pass over the batch per plane
+	for(size_t k=0; k<m_hPlaneZ.size(); k++)
+	{
+		const G4double dPlaneZ = m_hPlaneZ[k];
+		const G4int iPlane = (G4int) k;
+		for(G4int i=0; i<iNbPhotons; i++)
+		{
+			G4double dDistance = (dPlaneZ-pZ[i])*pInvDz[i];
+			G4bool bCloser = dDistance > s_dTolerance && dDistance < pStep[i];
+			pStep[i] = (bCloser)?(dDistance):(pStep[i]);
+			pInteraction[i] = (bCloser)?((G4int) PLANE):(pInteraction[i]);
+			pPlane[i] = (bCloser)?(iPlane):(pPlane[i]);
+		}
+	}
+
+	// transport with the group velocity of the medium
+	for(G4int i=0; i<iNbPhotons; i++)
+	{
+		G4bool bGas = pZ[i]+s_dTolerance*pDz[i] > dLiquidZ;
+		G4double dIndex = (bGas)?(pGroupIndexGXe[i]):(pGroupIndexLXe[i]);
+
+		pX[i] += pStep[i]*pDx[i];
+		pY[i] += pStep[i]*pDy[i];
+		pZ[i] += pStep[i]*pDz[i];
+		pTime[i] += pStep[i]*dIndex/c_light;
+	}
+}
+
+G4double muensterTPCOpticalRayTracer::GetValue(G4MaterialPropertyVector *pProperty, G4double dEnergy, G4double dDefault)
+{
+	return (pProperty)?(pProperty->Value(dEnergy)):(dDefault);
+}
+
+//******************************************************************/
+// n + E dn/dE, the group velocity c/(n + E dn/dE) of the tracked
+// photons (GROUPVEL), c/n if it would be faster
+//******************************************************************/
+G4double muensterTPCOpticalRayTracer::GetGroupIndex(G4MaterialPropertyVector *pRefractiveIndex, G4double dEnergy)
+{
+	if(!pRefractiveIndex)
+		return 1.;
+
+	G4double dIndex = pRefractiveIndex->Value(dEnergy);
+	G4double dDeltaE = 1e-3*dEnergy;
+	G4double dDerivative = (pRefractiveIndex->Value(dEnergy+dDeltaE)-pRefractiveIndex->Value(dEnergy-dDeltaE))/(2.*dDeltaE);
+
+	return std::max(dIndex+dEnergy*dDerivative, dIndex);
+}
+
+//******************************************************************/
+// interaction at the end of the step of one photon
+//******************************************************************/
+muensterTPCOpticalRayTracer::Fate muensterTPCOpticalRayTracer::Interact(G4int iPhoton)
+{
+	G4ThreeVector hDirection(m_hDx[iPhoton], m_hDy[iPhoton], m_hDz[iPhoton]);
+	G4double dEnergy = m_hEnergy[iPhoton];
+	G4int iMedium = (m_hZ[iPhoton]+s_dTolerance*m_hDz[iPhoton] > m_dLiquidZ)?(1):(0);
+
+	Fate eFate = ALIVE;
+	if(m_hInteraction[iPhoton] == BULK)
+	{
+		G4double dAbsorption = 1./GetValue(m_hMedia[iMedium].pAbsorptionLength, dEnergy, DBL_MAX);
+		if(G4UniformRand()*m_hAttenuation[iMedium][iPhoton] < dAbsorption)
+		{
+			m_lNbBulkAbsorbed++;
+			return ABSORBED;
+		}
+
+		// rayleigh scattering, 1+cos^2 for unpolarized photons
+		G4double dCosTheta;
+		do
+			dCosTheta = 2.*G4UniformRand()-1.;
+		while(2.*G4UniformRand() > 1.+dCosTheta*dCosTheta);
+
+		G4double dSinTheta = std::sqrt(1.-dCosTheta*dCosTheta);
+		G4double dPhi = twopi*G4UniformRand();
+		G4ThreeVector hScattered(dSinTheta*std::cos(dPhi), dSinTheta*std::sin(dPhi), dCosTheta);
+		hScattered.rotateUz(hDirection);
+		hDirection = hScattered;
+	}
+	else if(m_hInteraction[iPhoton] == WALL)
+	{
+		G4ThreeVector hNormal = G4ThreeVector(-m_hX[iPhoton], -m_hY[iPhoton], 0.).unit();
+		eFate = ReflectOnTeflon(m_hSurfaces[iMedium], dEnergy, hNormal, hDirection);
+	}
+	else
+	{
+		G4int iPlane = m_hPlane[iPhoton];
+		m_hZ[iPhoton] = m_hPlaneZ[iPlane];
+
+		switch(m_hPlaneType[iPlane])
+		{
+			case PLANE_MESH:
+				// path length through the mesh grows with 1/cos of the incidence angle
+				if(G4UniformRand() >= std::exp(-m_hPlaneThickness[iPlane]/(std::max(std::abs(hDirection.z()), DBL_MIN)*GetValue(m_hPlaneAbsorptionLength[iPlane], dEnergy, DBL_MAX))))
+					eFate = ABSORBED;
+				break;
+
+			case PLANE_LIQUID:
+				eFate = CrossLiquidSurface(iPhoton, hDirection);
+				break;
+
+			case PLANE_BOTTOM:
+				eFate = HitPmtArray(iPhoton, false, hDirection);
+				break;
+
+			case PLANE_TOP:
+				eFate = HitPmtArray(iPhoton, true, hDirection);
+				break;
+		}
+	}
+
+	if(eFate == ABSORBED)
+		m_lNbSurfaceAbsorbed++;
+
+	m_hDx[iPhoton] = hDirection.x();
+	m_hDy[iPhoton] = hDirection.y();
+	m_hDz[iPhoton] = hDirection.z();
+
+	return eFate;
+}
+
+//******************************************************************/
+// unified model (dielectric_metal, ground): reflectivity, then
+// specular spike, specular lobe around a facet normal (gaussian
+// sigma alpha), backscatter or lambertian; hNormal points into the xenon
+//******************************************************************/
+muensterTPCOpticalRayTracer::Fate muensterTPCOpticalRayTracer::ReflectOnTeflon(const SurfaceModel &hSurface, G4double dEnergy, const G4ThreeVector &hNormal, G4ThreeVector &hDirection)
+{
+	if(G4UniformRand() >= GetValue(hSurface.pReflectivity, dEnergy, 0.))
+		return ABSORBED;
+
+	G4double dSpike = GetValue(hSurface.pSpecularSpike, dEnergy, 0.);
+	G4double dLobe = GetValue(hSurface.pSpecularLobe, dEnergy, 0.);
+	G4double dBackscatter = GetValue(hSurface.pBackscatter, dEnergy, 0.);
+
+	G4double dRandom = G4UniformRand();
+	if(dRandom < dSpike)
+		hDirection -= 2.*(hDirection*hNormal)*hNormal;
+	else if(dRandom < dSpike+dLobe)
+	{
+		G4ThreeVector hReflected;
+		G4double dMax = std::min(1., 4.*hSurface.dSigmaAlpha);
+		G4int iNbTries = 0;
+		do
+		{
+			G4ThreeVector hFacetNormal = hNormal;
+			if(hSurface.dSigmaAlpha > 0.)
+			{
+				do
+				{
+					G4double dAlpha;
+					do
+						dAlpha = G4RandGauss::shoot(0., hSurface.dSigmaAlpha);
+					while(G4UniformRand()*dMax > std::sin(dAlpha) || dAlpha >= halfpi);
+
+					G4double dPhi = twopi*G4UniformRand();
+					hFacetNormal.set(std::sin(dAlpha)*std::cos(dPhi), std::sin(dAlpha)*std::sin(dPhi), std::cos(dAlpha));
+					hFacetNormal.rotateUz(hNormal);
+				}
+				while(hDirection*hFacetNormal >= 0.);
+			}
+
+			hReflected = hDirection-2.*(hDirection*hFacetNormal)*hFacetNormal;
+		}
+		while(hReflected*hNormal <= 0. && ++iNbTries < 100);
+
+		// grazing photons without a facet reflecting them back are reflected on the average surface
+		if(hReflected*hNormal <= 0.)
+			hReflected = hDirection-2.*(hDirection*hNormal)*hNormal;
+		hDirection = hReflected;
+	}
+	else if(dRandom < dSpike+dLobe+dBackscatter)
+		hDirection = -hDirection;
+	else
+		hDirection = LambertianDirection(hNormal);
+
+	return ALIVE;
+}
+
+G4ThreeVector muensterTPCOpticalRayTracer::LambertianDirection(const G4ThreeVector &hNormal)
+{
+	G4ThreeVector hDirection;
+	G4double dCosTheta;
+	do
+	{
+		hDirection = G4RandomDirection();
+		dCosTheta = hDirection*hNormal;
+		if(dCosTheta < 0.)
+		{
+			hDirection = -hDirection;
+			dCosTheta = -dCosTheta;
+		}
+	}
+	while(G4UniformRand() >= dCosTheta);
+
+	return hDirection;
+}
+
+//******************************************************************/
+// unpolarized, 1 for total internal reflection
+//******************************************************************/
+G4double muensterTPCOpticalRayTracer::FresnelReflectance(G4double dIndex1, G4double dIndex2, G4double dCosIncidence)
+{
+	G4double dSinTransmission = dIndex1/dIndex2*std::sqrt(std::max(0., 1.-dCosIncidence*dCosIncidence));
+	if(dSinTransmission >= 1.)
+		return 1.;
+
+	G4double dCosTransmission = std::sqrt(1.-dSinTransmission*dSinTransmission);
+	G4double dRs = (dIndex1*dCosIncidence-dIndex2*dCosTransmission)/(dIndex1*dCosIncidence+dIndex2*dCosTransmission);
+	G4double dRp = (dIndex1*dCosTransmission-dIndex2*dCosIncidence)/(dIndex1*dCosTransmission+dIndex2*dCosIncidence);
+
+	return 0.5*(dRs*dRs+dRp*dRp);
+}
+
+//******************************************************************/
+// flat liquid surface without optical surface: fresnel reflection or
+// refraction into the other phase
+//******************************************************************/
+muensterTPCOpticalRayTracer::Fate muensterTPCOpticalRayTracer::CrossLiquidSurface(G4int iPhoton, G4ThreeVector &hDirection)
+{
+	G4bool bFromLiquid = (hDirection.z() > 0.);
+	G4double dIndex1 = m_hIndex[(bFromLiquid)?(0):(1)][iPhoton];
+	G4double dIndex2 = m_hIndex[(bFromLiquid)?(1):(0)][iPhoton];
+	G4double dCosIncidence = std::abs(hDirection.z());
+
+	if(G4UniformRand() < FresnelReflectance(dIndex1, dIndex2, dCosIncidence))
+	{
+		hDirection.setZ(-hDirection.z());
+		return ALIVE;
+	}
+
+	G4double dRatio = dIndex1/dIndex2;
+	G4double dCosTransmission = std::sqrt(std::max(0., 1.-dRatio*dRatio*(1.-dCosIncidence*dCosIncidence)));
+	hDirection.set(dRatio*hDirection.x(), dRatio*hDirection.y(), (bFromLiquid)?(dCosTransmission):(-dCosTransmission));
+
+	return ALIVE;
+}
+
+//******************************************************************/
+// pmt window: fresnel reflection on the quartz, detected inside the
+// photocathode, absorbed on the border of the window; between the
+// windows: teflon of the pmt holder
+//******************************************************************/
+muensterTPCOpticalRayTracer::Fate muensterTPCOpticalRayTracer::HitPmtArray(G4int iPhoton, G4bool bTop, G4ThreeVector &hDirection)
+{
+	G4double dX = m_hX[iPhoton], dY = m_hY[iPhoton];
+	G4int iMedium = (bTop)?(1):(0);
+
+	for(size_t j=0; j<m_hPmtNb.size(); j++)
+	{
+		G4double dDx = std::abs(dX-m_hPmtX[j]), dDy = std::abs(dY-m_hPmtY[j]);
+		if(m_hPmtTop[j] != bTop || dDx >= m_dPmtWindowHalfWidth || dDy >= m_dPmtWindowHalfWidth)
+			continue;
+
+		G4double dIndex = m_hIndex[iMedium][iPhoton];
+		G4double dWindowIndex = GetValue(m_pWindowRefractiveIndex, m_hEnergy[iPhoton], dIndex);
+		if(G4UniformRand() < FresnelReflectance(dIndex, dWindowIndex, std::abs(hDirection.z())))
+		{
+			hDirection.setZ(-hDirection.z());
+			return ALIVE;
+		}
+
+		if(dDx >= m_dPmtPhotoCathodeHalfWidth || dDy >= m_dPmtPhotoCathodeHalfWidth)
+			return ABSORBED;
+
+		if(m_pPmtSD)
+			m_pPmtSD->AddPhoton(m_hPmtNb[j], m_hTime[iPhoton], G4ThreeVector(dX, dY, m_hZ[iPhoton]));
+		m_lNbDetected++;
+
+		return DETECTED;
+	}
+
+	return ReflectOnTeflon(m_hSurfaces[iMedium], m_hEnergy[iPhoton], G4ThreeVector(0., 0., (bTop)?(-1.):(1.)), hDirection);
+}
+
+void muensterTPCOpticalRayTracer::CopyPhoton(G4int iFrom, G4int iTo)
+{
+	m_hX[iTo] = m_hX[iFrom];
+	m_hY[iTo] = m_hY[iFrom];
+	m_hZ[iTo] = m_hZ[iFrom];
+	m_hDx[iTo] = m_hDx[iFrom];
+	m_hDy[iTo] = m_hDy[iFrom];
+	m_hDz[iTo] = m_hDz[iFrom];
+	m_hTime[iTo] = m_hTime[iFrom];
+	m_hEnergy[iTo] = m_hEnergy[iFrom];
+	for(G4int iMedium=0; iMedium<2; iMedium++)
+	{
+		m_hAttenuation[iMedium][iTo] = m_hAttenuation[iMedium][iFrom];
+		m_hIndex[iMedium][iTo] = m_hIndex[iMedium][iFrom];
+		m_hGroupIndex[iMedium][iTo] = m_hGroupIndex[iMedium][iFrom];
+	}
+}
+
+void muensterTPCOpticalRayTracer::EndOfEvent()
+{
+	if(m_iNbPhotons > 0)
+		TraceBatch();
+}
+
+void muensterTPCOpticalRayTracer::PrintStatistics()
+{
+	G4cout << "Optical ray tracer: " << m_lNbPhotons << " photons traced, " << m_lNbDetected << " detected, "
+		<< m_lNbBulkAbsorbed << " absorbed in the xenon, " << m_lNbSurfaceAbsorbed << " absorbed on surfaces";
+	if(m_lNbLost > 0)
+		G4cout << ", " << m_lNbLost << " lost after " << s_iMaxIterations << " interactions";
+	G4cout << G4endl;
+}
+
@@ -0,0 +1,197 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * 
+ * @comment 
+ ******************************************************************/
+#include <G4ParticleTable.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4ProcessTable.hh>
+#include <G4VProcess.hh>
+#include <G4ios.hh>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <TTree.h>
+
+#include "muensterTPCOutputDictionary.hh"
+
+using std::string;
+using std::vector;
+
+map<G4String, G4int> muensterTPCOutputDictionary::m_hSharedParticleCodes;
+map<G4int, G4String> muensterTPCOutputDictionary::m_hSharedParticleNames;
+std::mutex muensterTPCOutputDictionary::m_hParticleCodesMutex;
+
+muensterTPCOutputDictionary::muensterTPCOutputDictionary()
+{
+}
+
+muensterTPCOutputDictionary::~muensterTPCOutputDictionary()
+{
+}
+
+//******************************************************************/
+// number the processes of the physics list, the sorted names give
+// the same codes in all threads and processes of one simulation
+//******************************************************************/
+void muensterTPCOutputDictionary::Initialize()
+{
+	m_hParticleCodes.clear();
+	m_hParticleCodes["none"] = FindParticleCode("none");
+
+	m_hProcessCodes.clear();
+	m_hProcessCodes["Null"] = 0;
+
+	m_hParticleDefinitionCodes.clear();
+	m_hProcessPointerCodes.clear();
+
+	vector<G4String> hProcessNames(*(G4ProcessTable::GetProcessTable()->GetNameList()));
+	std::sort(hProcessNames.begin(), hProcessNames.end());
+	hProcessNames.erase(std::unique(hProcessNames.begin(), hProcessNames.end()), hProcessNames.end());
+
+	for(size_t i=0; i<hProcessNames.size(); i++)
+		m_hProcessCodes[hProcessNames[i]] = i+1;
+}
+
+G4int muensterTPCOutputDictionary::GetParticleCode(const G4String &hParticleName)
+{
+	map<G4String, G4int>::iterator pIt = m_hParticleCodes.find(hParticleName);
+	if(pIt != m_hParticleCodes.end())
+		return pIt->second;
+
+	G4int iCode = FindParticleCode(hParticleName);
+	m_hParticleCodes[hParticleName] = iCode;
+
+	return iCode;
+}
+
+//******************************************************************/
+// the PDG code if it is unique, Geant4 gives all excited ions without
+// level the same code (e.g. Kr83[41.557] and Kr83[9.405]), these and
+// particles without PDG code get a hash of their name, so the codes
+// of all threads, processes (-j) and runs agree
+//******************************************************************/
+G4int muensterTPCOutputDictionary::FindParticleCode(const G4String &hParticleName)
+{
+	std::lock_guard<std::mutex> hLock(m_hParticleCodesMutex);
+
+	map<G4String, G4int>::iterator pIt = m_hSharedParticleCodes.find(hParticleName);
+	if(pIt != m_hSharedParticleCodes.end())
+		return pIt->second;
+
+	G4int iCode = 0;
+	G4ParticleDefinition *pParticle = G4ParticleTable::GetParticleTable()->FindParticle(hParticleName);
+	if(pParticle)
+		iCode = pParticle->GetPDGEncoding();
+
+	G4bool bExcitedIon = (iCode >= 1000000000 && iCode%10 == 9);
+	if(hParticleName == "none")
+		iCode = 0;
+	else if(hParticleName == "geantino")
+		iCode = 2000000001;
+	else if(hParticleName == "chargedgeantino")
+		iCode = 2000000002;
+	else if(!iCode || bExcitedIon)
+	{
+		// 32 bit FNV-1a hash of the name in [2000000003, 2^31-1)
+		unsigned int uHash = 2166136261u;
+		for(size_t i=0; i<hParticleName.size(); i++)
+			uHash = (uHash ^ (unsigned char) hParticleName[i])*16777619u;
+
+		const G4int iFirstCode = 2000000003;
+		const G4int iNbCodes = 2147483647-iFirstCode;
+		iCode = iFirstCode + (G4int) (uHash % iNbCodes);
+	}
+
+	// hash collisions are resolved in the order of appearance, these codes may differ between files
+	while(m_hSharedParticleNames.count(iCode))
+	{
+		G4cout << "!!!!> particle code " << iCode << " of " << hParticleName << " is taken by " << m_hSharedParticleNames[iCode]
+			<< ", the code of " << hParticleName << " may differ between output files." << G4endl;
+		iCode = (iCode < 2147483646)?(iCode+1):(2000000003);
+	}
+
+	m_hSharedParticleCodes[hParticleName] = iCode;
+	m_hSharedParticleNames[iCode] = hParticleName;
+
+	return iCode;
+}
+
+G4int muensterTPCOutputDictionary::GetProcessCode(const G4String &hProcessName)
+{
+	map<G4String, G4int>::iterator pIt = m_hProcessCodes.find(hProcessName);
+	if(pIt != m_hProcessCodes.end())
+		return pIt->second;
+
+	return -1;
+}
+
+G4int muensterTPCOutputDictionary::GetParticleCode(const G4ParticleDefinition *pParticleDefinition)
+{
+	if(!pParticleDefinition)
+		return 0;
+
+	map<const G4ParticleDefinition *, G4int>::iterator pIt = m_hParticleDefinitionCodes.find(pParticleDefinition);
+	if(pIt != m_hParticleDefinitionCodes.end())
+		return pIt->second;
+
+	G4int iCode = GetParticleCode(pParticleDefinition->GetParticleName());
+	m_hParticleDefinitionCodes[pParticleDefinition] = iCode;
+
+	return iCode;
+}
+
+G4int muensterTPCOutputDictionary::GetProcessCode(const G4VProcess *pProcess)
+{
+	if(!pProcess)
+		return 0;
+
+	map<const G4VProcess *, G4int>::iterator pIt = m_hProcessPointerCodes.find(pProcess);
+	if(pIt != m_hProcessPointerCodes.end())
+		return pIt->second;
+
+	G4int iCode = GetProcessCode(pProcess->GetProcessName());
+	m_hProcessPointerCodes[pProcess] = iCode;
+
+	return iCode;
+}
+
+//******************************************************************/
+// write the dictionaries as small trees into the current directory,
+// merged files may contain entries several times
+//******************************************************************/
+void muensterTPCOutputDictionary::Write()
+{
+	Int_t iCode = 0;
+	string hName;
+
+	TTree *pParticleTree = new TTree("typedict", "Particle codes (type, parenttype, type_pri)");
+	pParticleTree->Branch("code", &iCode, "code/I");
+	pParticleTree->Branch("name", &hName);
+	{
+		// all codes given so far, the merged files have the same code for a name
+		std::lock_guard<std::mutex> hLock(m_hParticleCodesMutex);
+		for(map<G4int, G4String>::iterator pIt = m_hSharedParticleNames.begin(); pIt != m_hSharedParticleNames.end(); pIt++)
+		{
+			iCode = pIt->first;
+			hName = pIt->second;
+			pParticleTree->Fill();
+		}
+	}
+	pParticleTree->Write();
+
+	TTree *pProcessTree = new TTree("procdict", "Process codes (creaproc, edproc)");
+	pProcessTree->Branch("code", &iCode, "code/I");
+	pProcessTree->Branch("name", &hName);
+	for(map<G4String, G4int>::iterator pIt = m_hProcessCodes.begin(); pIt != m_hProcessCodes.end(); pIt++)
+	{
+		iCode = pIt->second;
+		hName = pIt->first;
+		pProcessTree->Fill();
+	}
+	pProcessTree->Write();
+}
@@ -0,0 +1,148 @@
+/******************************************************************
+ * muensterTPCsim
+ * 
+ * Simulations of the Muenster TPC
+ * 
+ * @comment 
+ ******************************************************************/
+#include <G4ios.hh>
+
+#include <chrono>
+
+#include <TROOT.h>
+
+#include "muensterTPCAnalysisManager.hh"
+#include "muensterTPCEventData.hh"
+#include "muensterTPCOutputWriter.hh"
+
+muensterTPCOutputWriter::muensterTPCOutputWriter(muensterTPCAnalysisManager *pAnalysisManager, G4int iQueueSize)
+{
+	m_pAnalysisManager = pAnalysisManager;
+	m_pTreeEventData = new muensterTPCEventData();
+
+	// the records keep their vectors, so the capacity is reused from event to event
+	for(G4int i=0; i<iQueueSize; i++)
+		m_hRecords.push_back(new muensterTPCEventData());
+
+	m_bStop = false;
+
+	m_iNbEvents = 0;
+	m_iNbStalls = 0;
+	m_iMaxQueueDepth = 0;
+	m_dSumQueueDepth = 0.;
+	m_dStallTime = 0.;
+}
+
+muensterTPCOutputWriter::~muensterTPCOutputWriter()
+{
+	Stop();
+
+	for(size_t i=0; i<m_hRecords.size(); i++)
+		delete m_hRecords[i];
+	delete m_pTreeEventData;
+}
+
+void muensterTPCOutputWriter::Start()
+{
+	// ROOT is used by the simulation thread and the writer thread
+	ROOT::EnableThreadSafety();
+
+	m_hFreeRecords.assign(m_hRecords.begin(), m_hRecords.end());
+	m_hQueuedRecords.clear();
+	m_bStop = false;
+
+	m_iNbEvents = 0;
+	m_iNbStalls = 0;
+	m_iMaxQueueDepth = 0;
+	m_dSumQueueDepth = 0.;
+	m_dStallTime = 0.;
+
+	m_hThread = std::thread(&muensterTPCOutputWriter::Run, this);
+}
+
+//******************************************************************/
+// simulation thread: swap the event into a free record (waits if the
+// queue is full) and hand it to the writer thread
+//******************************************************************/
+void muensterTPCOutputWriter::Push(muensterTPCEventData *pEventData)
+{
+	std::unique_lock<std::mutex> hLock(m_hMutex);
+
+	if(m_hFreeRecords.empty())
+	{
+		std::chrono::steady_clock::time_point hStart = std::chrono::steady_clock::now();
+		m_hRecordFreed.wait(hLock, [this]{ return !m_hFreeRecords.empty(); });
+		m_dStallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - hStart).count();
+		m_iNbStalls++;
+	}
+
+	muensterTPCEventData *pRecord = m_hFreeRecords.front();
+	m_hFreeRecords.pop_front();
+
+	pRecord->Swap(*pEventData);
+	m_hQueuedRecords.push_back(pRecord);
+
+	m_iNbEvents++;
+	m_dSumQueueDepth += m_hQueuedRecords.size();
+	if((G4int) m_hQueuedRecords.size() > m_iMaxQueueDepth)
+		m_iMaxQueueDepth = m_hQueuedRecords.size();
+
+	hLock.unlock();
+	m_hRecordQueued.notify_one();
+}
+
+//******************************************************************/
+// simulation thread: write the remaining events and end the writer thread
+//******************************************************************/
+void muensterTPCOutputWriter::Stop()
+{
+	if(!m_hThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> hLock(m_hMutex);
+		m_bStop = true;
+	}
+	m_hRecordQueued.notify_one();
+
+	m_hThread.join();
+}
+
+//******************************************************************/
+// writer thread: fill the tree with the queued records
+//******************************************************************/
+void muensterTPCOutputWriter::Run()
+{
+	while(true)
+	{
+		muensterTPCEventData *pRecord = 0;
+		{
+			std::unique_lock<std::mutex> hLock(m_hMutex);
+			m_hRecordQueued.wait(hLock, [this]{ return m_bStop || !m_hQueuedRecords.empty(); });
+
+			if(m_hQueuedRecords.empty())
+				return;
+
+			pRecord = m_hQueuedRecords.front();
+			m_hQueuedRecords.pop_front();
+		}
+
+		m_pTreeEventData->Swap(*pRecord);
+		m_pAnalysisManager->FillTree();
+		m_pTreeEventData->Clear();
+
+		{
+			std::lock_guard<std::mutex> hLock(m_hMutex);
+			m_hFreeRecords.push_back(pRecord);
+		}
+		m_hRecordFreed.notify_one();
+	}
+}
+
+void muensterTPCOutputWriter::PrintStatistics()
+{
+	G4cout << "Output writer thread: " << m_iNbEvents << " events, queue size " << m_hRecords.size()
+		<< ", mean queue depth " << ((m_iNbEvents)?(m_dSumQueueDepth/m_iNbEvents):(0.))
+		<< ", max queue depth " << m_iMaxQueueDepth
+		<< ", " << m_iNbStalls << " stalls (" << m_dStallTime << " s)" << G4endl;
+}
@@ -485,6 +485,9 @@ muensterTPCPhysicsList::ConstructEM()
 #include "G4OpRayleigh.hh"
 #include "G4OpBoundaryProcess.hh"
 #include "G4Cerenkov.hh"
+#include "G4FastSimulationManagerProcess.hh"
+
+#include "muensterTPCOpticalRayTracer.hh"
 
 void
 muensterTPCPhysicsList::ConstructOp()
@@ -597,6 +600,10 @@ muensterTPCPhysicsList::ConstructOp()
 			pmanager->AddDiscreteProcess(theAbsorptionProcess);
 			pmanager->AddDiscreteProcess(theRayleighScatteringProcess);
 			pmanager->AddDiscreteProcess(theBoundaryProcess);
+
+			// photons inside the TPC are handed to the optical ray tracer (see /Xe/optics/rayTracer)
+			if(muensterTPCOpticalRayTracer::IsEnabled())
+				pmanager->AddDiscreteProcess(new G4FastSimulationManagerProcess("fastSimProcess_massGeom"));
 		}
 		// ... and give those particles that need it a bit of Cerenkov.... and only if you want to
     if(fCerenkovProcess->IsApplicable(*particle) && m_bCerenkov){
@@ -0,0 +1,279 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+#include <G4ios.hh>
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "muensterTPCPmtDigitizer.hh"
+#include "muensterTPCEventData.hh"
+
+muensterTPCPmtDigitizer::muensterTPCPmtDigitizer()
+{
+	m_hMode = "off";
+
+	// 100 MHz digitizer, 1 us window
+	m_dSamplingPeriod = 10.*ns;
+	m_dWindowStart = -100.*ns;
+	m_dWindowLength = 1000.*ns;
+
+	m_dRiseTime = 3.*ns;
+	m_dFallTime = 10.*ns;
+
+	m_dGainSpread = 0.3;
+	m_dNoise = 0.;
+
+	m_dThreshold = 0.05;
+	m_iNbPreSamples = 5;
+	m_iNbPostSamples = 5;
+
+	m_iTemplateLength = 0;
+	m_iNbPmts = 0;
+	m_iNbSamples = 0;
+}
+
+muensterTPCPmtDigitizer::~muensterTPCPmtDigitizer()
+{
+}
+
+void muensterTPCPmtDigitizer::SetSpeShape(G4double dRiseTime, G4double dFallTime)
+{
+	m_dRiseTime = dRiseTime;
+	m_dFallTime = dFallTime;
+	m_hTemplateFileSamples.clear();
+}
+
+//******************************************************************/
+// single photoelectron pulse from a text file, one value per sample
+// (sampling period of the digitizer), lines starting with # are skipped
+//******************************************************************/
+G4bool muensterTPCPmtDigitizer::SetSpeTemplate(const G4String &hFileName)
+{
+	std::ifstream hFile(hFileName.c_str());
+	if(!hFile.is_open())
+	{
+		G4cout << "!!!!> digitizer: could not open the spe template " << hFileName << ", the template is not changed." << G4endl;
+		return false;
+	}
+
+	vector<G4double> hSamples;
+	std::string hLine;
+	while(std::getline(hFile, hLine))
+	{
+		if(hLine.empty() || hLine[0] == '#')
+			continue;
+
+		std::istringstream hStream(hLine);
+		G4double dValue;
+		if(hStream >> dValue)
+			hSamples.push_back(dValue);
+	}
+
+	if(hSamples.empty())
+	{
+		G4cout << "!!!!> digitizer: the spe template " << hFileName << " is empty, the template is not changed." << G4endl;
+		return false;
+	}
+
+	m_hTemplateFileSamples = hSamples;
+	return true;
+}
+
+void muensterTPCPmtDigitizer::SetZeroLengthEncoding(G4double dThreshold, G4int iNbPreSamples, G4int iNbPostSamples)
+{
+	m_dThreshold = dThreshold;
+	m_iNbPreSamples = iNbPreSamples;
+	m_iNbPostSamples = iNbPostSamples;
+}
+
+//******************************************************************/
+// waveform buffers and pulse templates of this run
+//******************************************************************/
+void muensterTPCPmtDigitizer::Initialize(G4int iNbPmts)
+{
+	m_iNbPmts = iNbPmts;
+	m_iNbSamples = std::max(1, (G4int) std::ceil(m_dWindowLength/m_dSamplingPeriod));
+
+	m_hWaveforms.assign(m_iNbPmts*m_iNbSamples, 0.f);
+	m_hIsHit.assign(m_iNbPmts, false);
+	m_hHitPmts.clear();
+
+	G4bool bTemplateFile = !m_hTemplateFileSamples.empty();
+	if(bTemplateFile)
+		m_iTemplateLength = m_hTemplateFileSamples.size()+1;
+	else
+		m_iTemplateLength = (G4int) std::ceil((m_dRiseTime+10.*m_dFallTime)/m_dSamplingPeriod)+1;
+
+	// the pulse sampled for photons arriving in the middle of each phase interval, normalized to the area 1
+	m_hTemplates.assign(m_iNbPhases*m_iTemplateLength, 0.f);
+	for(G4int iPhase=0; iPhase<m_iNbPhases; iPhase++)
+	{
+		G4double dPhase = (iPhase+0.5)/m_iNbPhases;
+		float *pTemplate = &m_hTemplates[iPhase*m_iTemplateLength];
+
+		G4double dSum = 0.;
+		for(G4int j=0; j<m_iTemplateLength; j++)
+		{
+			G4double dSample = j-dPhase;
+			G4double dValue = 0.;
+
+			if(dSample < 0.)
+				dValue = 0.;
+			else if(bTemplateFile)
+			{
+				G4int k = (G4int) dSample;
+				G4double dFraction = dSample-k;
+				G4double dLow = (k < (G4int) m_hTemplateFileSamples.size())?(m_hTemplateFileSamples[k]):(0.);
+				G4double dHigh = (k+1 < (G4int) m_hTemplateFileSamples.size())?(m_hTemplateFileSamples[k+1]):(0.);
+				dValue = (1.-dFraction)*dLow + dFraction*dHigh;
+			}
+			else
+			{
+				G4double dTime = dSample*m_dSamplingPeriod;
+				dValue = std::exp(-dTime/m_dFallTime);
+				if(m_dRiseTime > 0.)
+					dValue -= std::exp(-dTime/m_dRiseTime);
+			}
+
+			pTemplate[j] = (float) dValue;
+			dSum += dValue;
+		}
+
+		if(dSum != 0.)
+			for(G4int j=0; j<m_iTemplateLength; j++)
+				pTemplate[j] /= dSum;
+	}
+}
+
+//******************************************************************/
+// one pulse per photon, the noise is only added to the hit pmts
+//******************************************************************/
+void muensterTPCPmtDigitizer::Digitize(muensterTPCPmtHitsCollection *pPmtHitsCollection, const vector<G4int> *pRowPmts, muensterTPCEventData *pEventData)
+{
+	G4int iNbPmtHits = (pPmtHitsCollection)?(pPmtHitsCollection->entries()):(0);
+	for(G4int i=0; i<iNbPmtHits; i++)
+	{
+		muensterTPCPmtHit *pHit = (*pPmtHitsCollection)[i];
+		G4int iPmtNb = pHit->GetPmtNb();
+		if(iPmtNb < 0 || iPmtNb >= m_iNbPmts)
+			continue;
+
+		if(!m_hIsHit[iPmtNb])
+		{
+			m_hIsHit[iPmtNb] = true;
+			m_hHitPmts.push_back(iPmtNb);
+		}
+
+		AddPulse(&m_hWaveforms[iPmtNb*m_iNbSamples], pHit->GetTime());
+	}
+
+	sort(m_hHitPmts.begin(), m_hHitPmts.end());
+
+	if(m_dNoise > 0.)
+	{
+		for(size_t i=0; i<m_hHitPmts.size(); i++)
+		{
+			float *pWaveform = &m_hWaveforms[m_hHitPmts[i]*m_iNbSamples];
+			for(G4int j=0; j<m_iNbSamples; j++)
+				pWaveform[j] += (float) G4RandGauss::shoot(0., m_dNoise);
+		}
+	}
+
+	if(m_hMode == "area")
+	{
+		G4int iNbRows = (pRowPmts)?(pRowPmts->size()):(m_iNbPmts);
+		pEventData->m_pPmtArea->reserve(iNbRows);
+
+		for(G4int i=0; i<iNbRows; i++)
+		{
+			G4int iPmtNb = (pRowPmts)?((*pRowPmts)[i]):(i);
+
+			G4double dArea = 0.;
+			if(iPmtNb >= 0 && iPmtNb < m_iNbPmts && m_hIsHit[iPmtNb])
+			{
+				const float *pWaveform = &m_hWaveforms[iPmtNb*m_iNbSamples];
+				for(G4int j=0; j<m_iNbSamples; j++)
+					dArea += pWaveform[j];
+			}
+			pEventData->m_pPmtArea->push_back(dArea);
+		}
+	}
+	else if(m_hMode == "zle")
+	{
+		for(size_t i=0; i<m_hHitPmts.size(); i++)
+			FillZeroLengthEncoding(m_hHitPmts[i], &m_hWaveforms[m_hHitPmts[i]*m_iNbSamples], pEventData);
+	}
+
+	for(size_t i=0; i<m_hHitPmts.size(); i++)
+	{
+		std::fill_n(m_hWaveforms.begin()+m_hHitPmts[i]*m_iNbSamples, m_iNbSamples, 0.f);
+		m_hIsHit[m_hHitPmts[i]] = false;
+	}
+	m_hHitPmts.clear();
+}
+
+//******************************************************************/
+// scaled template added to the contiguous samples of the pmt, the
+// inner loop has no dependencies and is vectorized by the compiler
+//******************************************************************/
+void muensterTPCPmtDigitizer::AddPulse(float *pWaveform, G4double dTime)
+{
+	G4double dSample = (dTime-m_dWindowStart)/m_dSamplingPeriod;
+	if(dSample >= m_iNbSamples || dSample+m_iTemplateLength <= 0.)
+		return;
+
+	G4int iFirstSample = (G4int) std::floor(dSample);
+	G4int iPhase = std::min((G4int) ((dSample-iFirstSample)*m_iNbPhases), m_iNbPhases-1);
+
+	float fGain = 1.f;
+	if(m_dGainSpread > 0.)
+		fGain = (float) std::max(0., G4RandGauss::shoot(1., m_dGainSpread));
+
+	const float *pTemplate = &m_hTemplates[iPhase*m_iTemplateLength];
+	G4int iBegin = std::max(0, -iFirstSample);
+	G4int iEnd = std::min(m_iTemplateLength, m_iNbSamples-iFirstSample);
+
+	for(G4int j=iBegin; j<iEnd; j++)
+		pWaveform[iFirstSample+j] += fGain*pTemplate[j];
+}
+
+//******************************************************************/
+// samples above the threshold with m_iNbPreSamples before and
+// m_iNbPostSamples after, closer segments are merged
+//******************************************************************/
+void muensterTPCPmtDigitizer::FillZeroLengthEncoding(G4int iPmtNb, const float *pWaveform, muensterTPCEventData *pEventData)
+{
+	G4int i = 0;
+	while(i < m_iNbSamples)
+	{
+		if(pWaveform[i] <= m_dThreshold)
+		{
+			i++;
+			continue;
+		}
+
+		G4int iStart = std::max(0, i-m_iNbPreSamples);
+		G4int iLastAbove = i;
+		for(i++; i<m_iNbSamples && i<=iLastAbove+m_iNbPreSamples+m_iNbPostSamples; i++)
+			if(pWaveform[i] > m_dThreshold)
+				iLastAbove = i;
+		G4int iEnd = std::min(m_iNbSamples, iLastAbove+m_iNbPostSamples+1);
+
+		pEventData->m_pWaveformPmt->push_back(iPmtNb);
+		pEventData->m_pWaveformStart->push_back(iStart);
+		pEventData->m_pWaveformLength->push_back(iEnd-iStart);
+		pEventData->m_pWaveformData->insert(pEventData->m_pWaveformData->end(), pWaveform+iStart, pWaveform+iEnd);
+
+		i = iEnd;
+	}
+}
+
@@ -17,7 +17,7 @@
 #include "G4SystemOfUnits.hh"
 #include "muensterTPCPmtHit.hh"
 
-G4Allocator<muensterTPCPmtHit> muensterTPCPmtHitAllocator;
+G4ThreadLocal G4Allocator<muensterTPCPmtHit> *muensterTPCPmtHitAllocator = 0;
 
 muensterTPCPmtHit::muensterTPCPmtHit() {}
 
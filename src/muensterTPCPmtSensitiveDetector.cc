@@ -9,21 +9,38 @@
  * @comment 
  ******************************************************************/
 #include <G4HCofThisEvent.hh>
+#include <G4SystemOfUnits.hh>
 #include <G4Step.hh>
 #include <G4VProcess.hh>
 #include <G4ThreeVector.hh>
 #include <G4SDManager.hh>
+#include <G4OpticalPhoton.hh>
 #include <G4ios.hh>
+#include <Randomize.hh>
 
 #include <map>
+#include <algorithm>
 
 using namespace std;
 
 #include "muensterTPCPmtSensitiveDetector.hh"
 
+G4bool muensterTPCPmtSensitiveDetector::m_bStoreHits = false;
+G4int muensterTPCPmtSensitiveDetector::m_iNbTimeBins = 0;
+G4double muensterTPCPmtSensitiveDetector::m_dTimeMin = 0.;
+G4double muensterTPCPmtSensitiveDetector::m_dTimeMax = 0.;
+G4double muensterTPCPmtSensitiveDetector::m_dMaxEfficiency = 1.;
+vector<G4double> muensterTPCPmtSensitiveDetector::m_hRelativeEfficiencies;
+
 muensterTPCPmtSensitiveDetector::muensterTPCPmtSensitiveDetector(G4String hName): G4VSensitiveDetector(hName)
 {
 	collectionName.insert("PmtHitsCollection");
+
+	m_iHitsCollectionID = -1;
+
+	m_pOpticalPhotonDefinition = G4OpticalPhoton::Definition();
+
+	m_iNbHits = 0;
 }
 
 muensterTPCPmtSensitiveDetector::~muensterTPCPmtSensitiveDetector()
@@ -32,39 +49,155 @@ muensterTPCPmtSensitiveDetector::~muensterTPCPmtSensitiveDetector()
 
 void muensterTPCPmtSensitiveDetector::Initialize(G4HCofThisEvent* pHitsCollectionOfThisEvent)
 {
+	// empty if only the hits per pmt are counted
 	m_pPmtHitsCollection = new muensterTPCPmtHitsCollection(SensitiveDetectorName, collectionName[0]);
 
-	static G4int iHitsCollectionID = -1;
-
-	if(iHitsCollectionID < 0)
-		iHitsCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+	// one sensitive detector per thread, hence no function static
+	if(m_iHitsCollectionID < 0)
+		m_iHitsCollectionID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
 	
-	pHitsCollectionOfThisEvent->AddHitsCollection(iHitsCollectionID, m_pPmtHitsCollection); 
+	pHitsCollectionOfThisEvent->AddHitsCollection(m_iHitsCollectionID, m_pPmtHitsCollection); 
+
+	// only the pmts hit in the last event have to be reset, unless the binning changed
+	G4bool bTimeBinningChanged = (m_hTimeHistograms.size() != m_hPmtCounts.size()*m_iNbTimeBins);
+	if(bTimeBinningChanged)
+		m_hTimeHistograms.assign(m_hPmtCounts.size()*m_iNbTimeBins, 0);
+
+	for(size_t i=0; i<m_hHitPmts.size(); i++)
+	{
+		m_hPmtCounts[m_hHitPmts[i]] = 0;
+		if(!bTimeBinningChanged)
+			fill_n(m_hTimeHistograms.begin()+m_hHitPmts[i]*m_iNbTimeBins, m_iNbTimeBins, 0);
+	}
+	m_hHitPmts.clear();
+	m_iNbHits = 0;
 }
 
 G4bool muensterTPCPmtSensitiveDetector::ProcessHits(G4Step* pStep, G4TouchableHistory *pHistory)
 {
 	G4Track *pTrack = pStep->GetTrack();
 
-	if(pTrack->GetDefinition()->GetParticleName() == "opticalphoton")
+	if(pTrack->GetDefinition() != m_pOpticalPhotonDefinition)
+		return false;
+
+	G4int iPmtNb = pStep->GetPreStepPoint()->GetTouchable()->GetCopyNumber(1);
+
+	return AddPhoton(iPmtNb, pTrack->GetGlobalTime(), pStep->GetPreStepPoint()->GetPosition());
+}
+
+//******************************************************************/
+// one detected photon, from ProcessHits or traced without Geant4
+// stepping (see /Xe/optics/rayTracer)
+//******************************************************************/
+G4bool muensterTPCPmtSensitiveDetector::AddPhoton(G4int iPmtNb, G4double dTime, const G4ThreeVector &hPosition)
+{
+	// the maximum efficiency was applied at the creation of the photon
+	if(iPmtNb < (G4int) m_hRelativeEfficiencies.size() && G4UniformRand() >= m_hRelativeEfficiencies[iPmtNb])
+		return false;
+
+	if(iPmtNb >= (G4int) m_hPmtCounts.size())
+	{
+		m_hPmtCounts.resize(iPmtNb+1, 0);
+		m_hFirstTimes.resize(iPmtNb+1, 0.);
+		m_hTimeHistograms.resize((iPmtNb+1)*m_iNbTimeBins, 0);
+	}
+
+	if(m_hPmtCounts[iPmtNb]++ == 0)
+	{
+		m_hHitPmts.push_back(iPmtNb);
+		m_hFirstTimes[iPmtNb] = dTime;
+	}
+	else if(dTime < m_hFirstTimes[iPmtNb])
+		m_hFirstTimes[iPmtNb] = dTime;
+	m_iNbHits++;
+
+	// photons outside of the range are only counted
+	if(m_iNbTimeBins > 0 && dTime >= m_dTimeMin && dTime < m_dTimeMax)
+	{
+		G4int iBin = (G4int) ((dTime-m_dTimeMin)/(m_dTimeMax-m_dTimeMin)*m_iNbTimeBins);
+		m_hTimeHistograms[iPmtNb*m_iNbTimeBins+std::min(iBin, m_iNbTimeBins-1)]++;
+	}
+
+	if(m_bStoreHits)
 	{
 		muensterTPCPmtHit* pHit = new muensterTPCPmtHit();
 
-		pHit->SetPosition(pStep->GetPreStepPoint()->GetPosition());
-		pHit->SetTime(pTrack->GetGlobalTime());
-		pHit->SetPmtNb(pTrack->GetTouchable()->GetVolume(1)->GetCopyNo());
+		pHit->SetPosition(hPosition);
+		pHit->SetTime(dTime);
+		pHit->SetPmtNb(iPmtNb);
 
 		m_pPmtHitsCollection->insert(pHit);
 
 //        pHit->Print();
 //        pHit->Draw();
+	}
+
+	return true;
+}
+
+//******************************************************************/
+// no time: a pmt with only these photons has the first time -1 and
+// an empty time histogram
+//******************************************************************/
+void muensterTPCPmtSensitiveDetector::AddCounts(G4int iPmtNb, G4int iNbCounts)
+{
+	if(iPmtNb < (G4int) m_hRelativeEfficiencies.size())
+		iNbCounts = (G4int) CLHEP::RandBinomial::shoot(iNbCounts, m_hRelativeEfficiencies[iPmtNb]);
+	if(iNbCounts <= 0)
+		return;
 
-		return true;
+	if(iPmtNb >= (G4int) m_hPmtCounts.size())
+	{
+		m_hPmtCounts.resize(iPmtNb+1, 0);
+		m_hFirstTimes.resize(iPmtNb+1, 0.);
+		m_hTimeHistograms.resize((iPmtNb+1)*m_iNbTimeBins, 0);
 	}
-	else
+
+	if(m_hPmtCounts[iPmtNb] == 0)
 	{
-		return false;
+		m_hHitPmts.push_back(iPmtNb);
+		m_hFirstTimes[iPmtNb] = -1.*ns;
+	}
+	m_hPmtCounts[iPmtNb] += iNbCounts;
+	m_iNbHits += iNbCounts;
+}
+
+void muensterTPCPmtSensitiveDetector::SetTimeHistograms(G4int iNbTimeBins, G4double dTimeMin, G4double dTimeMax)
+{
+	if(iNbTimeBins > 0 && dTimeMax <= dTimeMin)
+	{
+		G4cout << "!!!!> pmt time histograms: empty time range, histograms are switched off." << G4endl;
+		iNbTimeBins = 0;
+	}
+
+	m_iNbTimeBins = (iNbTimeBins > 0)?(iNbTimeBins):(0);
+	m_dTimeMin = dTimeMin;
+	m_dTimeMax = dTimeMax;
+}
+
+//******************************************************************/
+// one value for all pmts (only pre-sampling) or one per pmt, empty: off
+//******************************************************************/
+void muensterTPCPmtSensitiveDetector::SetEfficiencies(const vector<G4double> &hEfficiencies)
+{
+	m_dMaxEfficiency = 1.;
+	m_hRelativeEfficiencies.clear();
+
+	if(hEfficiencies.empty())
+		return;
+
+	G4double dMaxEfficiency = *max_element(hEfficiencies.begin(), hEfficiencies.end());
+	G4double dMinEfficiency = *min_element(hEfficiencies.begin(), hEfficiencies.end());
+	if(dMinEfficiency < 0. || dMaxEfficiency <= 0. || dMaxEfficiency > 1.)
+	{
+		G4cout << "!!!!> pmt efficiencies: the efficiencies have to be in (0, 1], efficiencies are switched off." << G4endl;
+		return;
 	}
+
+	m_dMaxEfficiency = dMaxEfficiency;
+	if(dMinEfficiency < dMaxEfficiency)
+		for(size_t i=0; i<hEfficiencies.size(); i++)
+			m_hRelativeEfficiencies.push_back(hEfficiencies[i]/dMaxEfficiency);
 }
 
 void muensterTPCPmtSensitiveDetector::EndOfEvent(G4HCofThisEvent *pHitsCollectionOfThisEvent)
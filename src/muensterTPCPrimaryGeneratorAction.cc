@@ -28,6 +28,9 @@ muensterTPCPrimaryGeneratorAction::muensterTPCPrimaryGeneratorAction()
 
 	m_lSeeds[0] = -1;
 	m_lSeeds[1] = -1;
+
+	m_iReplayEventId = -1;
+	m_bFromPostponedStack = false;
 }
 
 muensterTPCPrimaryGeneratorAction::~muensterTPCPrimaryGeneratorAction()
@@ -35,21 +38,48 @@ muensterTPCPrimaryGeneratorAction::~muensterTPCPrimaryGeneratorAction()
 	delete m_pParticleSource;
 }
 
+void
+muensterTPCPrimaryGeneratorAction::AddReplayEvent(G4int iEventId, long lSeed0, long lSeed1)
+{
+	m_hReplayEventIds.push_back(iEventId);
+	m_hReplaySeeds.push_back(lSeed0);
+	m_hReplaySeeds.push_back(lSeed1);
+}
+
 void
 muensterTPCPrimaryGeneratorAction::GeneratePrimaries(G4Event *pEvent)
 {
+	G4StackManager *pStackManager = (G4RunManagerKernel::GetRunManagerKernel())->GetStackManager();
+
+	// replay: restore the engine state of the recorded event, the whole event follows from it
+	m_iReplayEventId = -1;
+	if(!m_hReplayEventIds.empty())
+	{
+		// the decay products of the previous replayed event are not part of the next one
+		if(pStackManager->GetNPostponedTrack())
+			pStackManager->ClearPostponeStack();
+
+
+		long lReplaySeeds[2] = {m_hReplaySeeds[0], m_hReplaySeeds[1]};
+		CLHEP::HepRandom::setTheSeeds(lReplaySeeds);
+
+		m_iReplayEventId = m_hReplayEventIds.front();
+		m_hReplayEventIds.pop_front();
+		m_hReplaySeeds.pop_front();
+		m_hReplaySeeds.pop_front();
+	}
+
 	m_lSeeds[0] = *(CLHEP::HepRandom::getTheSeeds());
 	m_lSeeds[1] = *(CLHEP::HepRandom::getTheSeeds()+1);
 
-	G4StackManager *pStackManager = (G4RunManagerKernel::GetRunManagerKernel())->GetStackManager();
-
 //    G4cout << "PrimaryGeneratorAction: track status: "
 //        << pStackManager->GetNUrgentTrack() << " urgent, "
 //        << pStackManager->GetNWaitingTrack() << " waiting, "
 //        << pStackManager->GetNPostponedTrack() << " postponed"
 //        << G4endl;
 
-	if(!pStackManager->GetNPostponedTrack())
+	m_bFromPostponedStack = (pStackManager->GetNPostponedTrack() > 0);
+	if(!m_bFromPostponedStack)
 	{
 		m_pParticleSource->GeneratePrimaryVertex(pEvent);
 	}
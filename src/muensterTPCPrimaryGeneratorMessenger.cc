@@ -11,9 +11,11 @@
 #include <G4UIcmdWithADouble.hh>
 #include <G4UIcmdWithABool.hh>
 #include <G4Tokenizer.hh>
+#include <G4RunManager.hh>
 #include <G4ios.hh>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "muensterTPCPrimaryGeneratorMessenger.hh"
 #include "muensterTPCPrimaryGeneratorAction.hh"
@@ -26,6 +28,25 @@ muensterTPCPrimaryGeneratorMessenger::muensterTPCPrimaryGeneratorMessenger(muens
   m_pWriteEmptyCmd->SetGuidance("Write empty events to the root tree true/false");
   m_pWriteEmptyCmd->SetDefaultValue(false);
   //m_pWriteEmptyCmd->AvailableForStates(G4State_PreInit);
+
+  // replay a recorded event (see branches eventid, seed0, seed1)
+  m_pReplayEventCmd = new G4UIcommand("/run/replayEvent", this);
+  m_pReplayEventCmd->SetGuidance("Simulate the next event with the recorded random seeds of an event.");
+  m_pReplayEventCmd->SetGuidance("Can be called several times, the events are replayed in this order with /run/beamOn.");
+  m_pReplayEventCmd->SetGuidance("Only in a sequential run (no worker threads), events with postponed = 1 can not be replayed.");
+  m_pReplayEventCmd->SetGuidance("[usage] /run/replayEvent eventid seed0 seed1 [postponed]");
+
+  G4UIparameter *pParameter;
+  pParameter = new G4UIparameter("eventid", 'i', false);
+  m_pReplayEventCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("seed0", 'i', false);
+  m_pReplayEventCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("seed1", 'i', false);
+  m_pReplayEventCmd->SetParameter(pParameter);
+  pParameter = new G4UIparameter("postponed", 'i', true);
+  pParameter->SetDefaultValue("0");
+  m_pReplayEventCmd->SetParameter(pParameter);
+  m_pReplayEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 muensterTPCPrimaryGeneratorMessenger::~muensterTPCPrimaryGeneratorMessenger()
@@ -38,5 +59,22 @@ muensterTPCPrimaryGeneratorMessenger::SetNewValue(G4UIcommand * command, G4Strin
 {
   if(command == m_pWriteEmptyCmd) 
     m_pPrimaryGeneratorAction->SetWriteEmpty(m_pWriteEmptyCmd->GetNewBoolValue(newValues));
+
+  if(command == m_pReplayEventCmd)
+  {
+    G4int iEventId = 0, iPostponed = 0;
+    long lSeed0 = 0, lSeed1 = 0;
+    std::istringstream hStream(newValues);
+    hStream >> iEventId >> lSeed0 >> lSeed1 >> iPostponed;
+
+    // every worker would simulate the event once
+    if(G4RunManager::GetRunManager()->GetRunManagerType() != G4RunManager::sequentialRM)
+      G4cout << "!!!!> /run/replayEvent: events can only be replayed in a sequential run (no -t), event " << iEventId << " is not replayed." << G4endl;
+    // the primary was a postponed decay track, the seeds would give a new source primary
+    else if(iPostponed)
+      G4cout << "!!!!> /run/replayEvent: event " << iEventId << " started from a postponed decay track and can not be replayed." << G4endl;
+    else
+      m_pPrimaryGeneratorAction->AddReplayEvent(iEventId, lSeed0, lSeed1);
+  }
 }
 
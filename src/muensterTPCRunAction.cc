@@ -18,6 +18,7 @@
 
 muensterTPCRunAction::muensterTPCRunAction(muensterTPCAnalysisManager *pAnalysisManager) {
 	m_pAnalysisManager = pAnalysisManager;
+	m_lSeedIndex = -1;
 }
 
 muensterTPCRunAction::~muensterTPCRunAction() {
@@ -25,24 +26,25 @@ muensterTPCRunAction::~muensterTPCRunAction() {
 }
 
 void muensterTPCRunAction::BeginOfRunAction(const G4Run *pRun) {
+	// every thread has its own analysis manager (the master merges the worker files)
+	if(m_pAnalysisManager)
+		m_pAnalysisManager->BeginOfRun(pRun);
+
+	// the seeds of the worker threads are generated by the master
 	if (( ! G4Threading::IsMultithreadedApplication() ) ||
 			( G4Threading::IsMultithreadedApplication() && ! G4Threading::IsWorkerThread() )) {
-		if(m_pAnalysisManager)
-			m_pAnalysisManager->BeginOfRun(pRun);
-
 		struct timeval hTimeValue;
 		gettimeofday(&hTimeValue, NULL);
 		
-		CLHEP::HepRandom::setTheEngine(new CLHEP::RanecuEngine);
-		CLHEP::HepRandom::setTheSeed(hTimeValue.tv_usec);
+		// forked processes (-j) get disjoint seeds from the table of the RanecuEngine
+		if(m_lSeedIndex >= 0)
+			CLHEP::HepRandom::setTheSeed(m_lSeedIndex);
+		else
+			CLHEP::HepRandom::setTheSeed(hTimeValue.tv_usec);
 	}
 }
 
 void muensterTPCRunAction::EndOfRunAction(const G4Run *pRun) {
-	if (( ! G4Threading::IsMultithreadedApplication() ) ||
-				( G4Threading::IsMultithreadedApplication() && ! G4Threading::IsWorkerThread() )) {
-		if(m_pAnalysisManager)
-			m_pAnalysisManager->EndOfRun(pRun);
-	}
+	if(m_pAnalysisManager)
+		m_pAnalysisManager->EndOfRun(pRun);
 }
-
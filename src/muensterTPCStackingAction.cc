@@ -15,14 +15,20 @@
 #include <G4Event.hh>
 #include <G4VProcess.hh>
 #include <G4StackManager.hh>
+#include <Randomize.hh>
 
 #include "muensterTPCAnalysisManager.hh"
+#include "muensterTPCFastOptics.hh"
+#include "muensterTPCPmtSensitiveDetector.hh"
 
 #include "muensterTPCStackingAction.hh"
 
 muensterTPCStackingAction::muensterTPCStackingAction(muensterTPCAnalysisManager *pAnalysisManager)
 {
 	m_pAnalysisManager = pAnalysisManager;
+
+	m_lNbOpticalPhotons = 0;
+	m_lNbKilledOpticalPhotons = 0;
 }
 
 muensterTPCStackingAction::~muensterTPCStackingAction()
@@ -34,6 +40,24 @@ muensterTPCStackingAction::ClassifyNewTrack(const G4Track *pTrack)
 {
 	G4ClassificationOfNewTrack hTrackClassification = fUrgent;
 
+	// efficiency pre-sampling: photons which would not be detected by the most efficient pmt
+	// are killed at their creation, the pmts apply their efficiency relative to the maximum
+	if(muensterTPCPmtSensitiveDetector::IsPreSampling() && pTrack->GetDefinition() == G4OpticalPhoton::Definition())
+	{
+		m_lNbOpticalPhotons++;
+		if(G4UniformRand() >= muensterTPCPmtSensitiveDetector::GetMaxEfficiency())
+		{
+			m_lNbKilledOpticalPhotons++;
+			return fKill;
+		}
+	}
+
+	// fast optics: scintillation photons inside the lce map are counted instead of tracked
+	muensterTPCFastOptics *pFastOptics = (m_pAnalysisManager)?(m_pAnalysisManager->GetFastOptics()):(0);
+	if(pFastOptics && pTrack->GetDefinition() == G4OpticalPhoton::Definition() && pTrack->GetCreatorProcess()
+		&& pTrack->GetCreatorProcess()->GetProcessName() == "Scintillation" && pFastOptics->AddPhoton(pTrack->GetPosition()))
+		return fKill;
+
 	if(pTrack->GetDefinition()->GetParticleType() == "nucleus" && !pTrack->GetDefinition()->GetPDGStable())
 	{
 		if(pTrack->GetParentID() > 0 && pTrack->GetCreatorProcess()->GetProcessName() == "RadioactiveDecay")
@@ -53,3 +77,19 @@ muensterTPCStackingAction::PrepareNewEvent()
 { 
 }
 
+void
+muensterTPCStackingAction::ResetStatistics()
+{
+	m_lNbOpticalPhotons = 0;
+	m_lNbKilledOpticalPhotons = 0;
+}
+
+void
+muensterTPCStackingAction::PrintStatistics()
+{
+	if(!m_lNbOpticalPhotons)
+		return;
+
+	G4cout << "pmt efficiency pre-sampling: " << m_lNbKilledOpticalPhotons << " of " << m_lNbOpticalPhotons
+		<< " optical photons killed at creation (" << 100.*m_lNbKilledOpticalPhotons/m_lNbOpticalPhotons << " %)" << G4endl;
+}
@@ -0,0 +1,262 @@
+/******************************************************************
+ * muensterTPCsim
+ *
+ * Simulations of the Muenster TPC
+ *
+ * @comment
+ ******************************************************************/
+#include <G4SystemOfUnits.hh>
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4VTouchable.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4PhysicalVolumeStore.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Neutron.hh>
+#include <G4EventManager.hh>
+#include <G4StackManager.hh>
+#include <G4SDManager.hh>
+#include <G4Tokenizer.hh>
+#include <G4Material.hh>
+#include <G4ios.hh>
+
+#include "muensterTPCLXeSensitiveDetector.hh"
+#include "muensterTPCDetectorConstruction.hh"
+
+#include "muensterTPCSteppingAction.hh"
+
+vector<G4String> muensterTPCSteppingAction::m_hKillVolumeNames;
+G4double muensterTPCSteppingAction::m_dKillEnergy = 0.;
+G4bool muensterTPCSteppingAction::m_bAbortOnPrimaryExit = false;
+
+const char *muensterTPCSteppingAction::m_szRegionNames[NB_REGIONS] = { "LXe", "GXe", "gaps" };
+G4double muensterTPCSteppingAction::m_dPhotonMaxTrackLength[NB_REGIONS] = { 0., 0., 0. };
+G4double muensterTPCSteppingAction::m_dPhotonMaxTime[NB_REGIONS] = { 0., 0., 0. };
+G4int muensterTPCSteppingAction::m_iPhotonMaxBoundaries[NB_REGIONS] = { 0, 0, 0 };
+
+muensterTPCSteppingAction::muensterTPCSteppingAction()
+{
+	m_pLXeSD = 0;
+
+	m_lNbKilledLeavingTracks = 0;
+	m_lNbKilledLowEnergyTracks = 0;
+	m_lNbAbortedEvents = 0;
+
+	m_pLXeMaterial = 0;
+	m_pGXeMaterial = 0;
+	m_dTpcRadius = 0.;
+	m_iNbPhotonBoundaries = 0;
+
+	for(G4int i=0; i<NB_REGIONS; i++)
+		for(G4int j=0; j<NB_LIMITS; j++)
+			m_lNbKilledPhotons[i][j] = 0;
+}
+
+muensterTPCSteppingAction::~muensterTPCSteppingAction()
+{
+}
+
+//******************************************************************/
+// physical volume names separated by spaces or commas, none: off
+//******************************************************************/
+void muensterTPCSteppingAction::SetKillVolumes(const G4String &hVolumeNames)
+{
+	m_hKillVolumeNames.clear();
+
+	G4Tokenizer next(hVolumeNames);
+	for(G4String hVolumeName = next(" ,"); !hVolumeName.empty(); hVolumeName = next(" ,"))
+	{
+		if(hVolumeName != "none")
+			m_hKillVolumeNames.push_back(hVolumeName);
+	}
+}
+
+G4bool muensterTPCSteppingAction::IsRegion(const G4String &hRegion, G4int iRegion)
+{
+	return hRegion == "all" || hRegion == m_szRegionNames[iRegion];
+}
+
+void muensterTPCSteppingAction::SetPhotonMaxTrackLength(const G4String &hRegion, G4double dMaxTrackLength)
+{
+	for(G4int i=0; i<NB_REGIONS; i++)
+		if(IsRegion(hRegion, i))
+			m_dPhotonMaxTrackLength[i] = dMaxTrackLength;
+}
+
+void muensterTPCSteppingAction::SetPhotonMaxTime(const G4String &hRegion, G4double dMaxTime)
+{
+	for(G4int i=0; i<NB_REGIONS; i++)
+		if(IsRegion(hRegion, i))
+			m_dPhotonMaxTime[i] = dMaxTime;
+}
+
+void muensterTPCSteppingAction::SetPhotonMaxBoundaries(const G4String &hRegion, G4int iMaxBoundaries)
+{
+	for(G4int i=0; i<NB_REGIONS; i++)
+		if(IsRegion(hRegion, i))
+			m_iPhotonMaxBoundaries[i] = iMaxBoundaries;
+}
+
+G4bool muensterTPCSteppingAction::HasPhotonLimits()
+{
+	for(G4int i=0; i<NB_REGIONS; i++)
+		if(m_dPhotonMaxTrackLength[i] > 0. || m_dPhotonMaxTime[i] > 0. || m_iPhotonMaxBoundaries[i] > 0)
+			return true;
+
+	return false;
+}
+
+void muensterTPCSteppingAction::Initialize()
+{
+	// the geometry is built when the run starts, replicas share their name
+	m_hKillVolumes.clear();
+	G4PhysicalVolumeStore *pPhysicalVolumeStore = G4PhysicalVolumeStore::GetInstance();
+	for(size_t i=0; i<m_hKillVolumeNames.size(); i++)
+	{
+		G4bool bFound = false;
+		for(size_t j=0; j<pPhysicalVolumeStore->size(); j++)
+		{
+			if((*pPhysicalVolumeStore)[j]->GetName() == m_hKillVolumeNames[i])
+			{
+				m_hKillVolumes.push_back((*pPhysicalVolumeStore)[j]);
+				bFound = true;
+			}
+		}
+
+		if(!bFound)
+			G4cout << "!!!!> track killing: no physical volume " << m_hKillVolumeNames[i] << ", ignored." << G4endl;
+	}
+
+	m_pLXeSD = dynamic_cast<muensterTPCLXeSensitiveDetector *>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("muensterTPC/LXeSD", false));
+
+	m_lNbKilledLeavingTracks = 0;
+	m_lNbKilledLowEnergyTracks = 0;
+	m_lNbAbortedEvents = 0;
+
+	// the optical regions: xenon inside the PTFE cylinder, the rest are gaps
+	m_pLXeMaterial = G4Material::GetMaterial("LXe", false);
+	m_pGXeMaterial = G4Material::GetMaterial("GXe", false);
+	m_dTpcRadius = muensterTPCDetectorConstruction::GetGeometryParameter("TeflonCentralCylinderInnerRadius");
+	m_iNbPhotonBoundaries = 0;
+
+	for(G4int i=0; i<NB_REGIONS; i++)
+		for(G4int j=0; j<NB_LIMITS; j++)
+			m_lNbKilledPhotons[i][j] = 0;
+}
+
+//******************************************************************/
+// optical photons are only subject to the photon limits, neutrons and nuclei (decays at
+// rest) are not killed by the energy cut
+//******************************************************************/
+void muensterTPCSteppingAction::UserSteppingAction(const G4Step *pStep)
+{
+	G4Track *pTrack = pStep->GetTrack();
+	const G4ParticleDefinition *pParticleDefinition = pTrack->GetDefinition();
+	if(pParticleDefinition == G4OpticalPhoton::Definition())
+	{
+		if(pTrack->GetTrackStatus() == fAlive && HasPhotonLimits())
+			ApplyPhotonLimits(pStep);
+		return;
+	}
+
+	if(!IsEnabled() || pTrack->GetTrackStatus() != fAlive)
+		return;
+
+	G4StepPoint *pPostStepPoint = pStep->GetPostStepPoint();
+
+	// leaving the kill volumes, only checked on volume boundaries
+	if(!m_hKillVolumes.empty() && pPostStepPoint->GetStepStatus() == fGeomBoundary && pPostStepPoint->GetPhysicalVolume()
+		&& IsInKillVolumes(pStep->GetPreStepPoint()->GetTouchable()) && !IsInKillVolumes(pPostStepPoint->GetTouchable()))
+	{
+		pTrack->SetTrackStatus(fStopAndKill);
+		m_lNbKilledLeavingTracks++;
+
+		// secondaries still pending on the stack (e.g. gammas of (n,n') or bremsstrahlung outside
+		// the LXe) may reach the LXe, only abort when nothing is left to track
+		if(m_bAbortOnPrimaryExit && pTrack->GetParentID() == 0 && !(m_pLXeSD && (m_pLXeSD->HasDeposits() || m_pLXeSD->HasSecondaries()))
+			&& G4EventManager::GetEventManager()->GetStackManager()->GetNTotalTrack() == 0)
+		{
+			G4EventManager::GetEventManager()->AbortCurrentEvent();
+			m_lNbAbortedEvents++;
+		}
+		return;
+	}
+
+	if(m_dKillEnergy > 0. && pTrack->GetKineticEnergy() < m_dKillEnergy
+		&& pParticleDefinition != G4Neutron::Definition() && pParticleDefinition->GetParticleType() != "nucleus"
+		&& (!m_pLXeSD || pPostStepPoint->GetSensitiveDetector() != m_pLXeSD))
+	{
+		pTrack->SetTrackStatus(fStopAndKill);
+		m_lNbKilledLowEnergyTracks++;
+	}
+}
+
+G4bool muensterTPCSteppingAction::IsInKillVolumes(const G4VTouchable *pTouchable)
+{
+	for(G4int iDepth=0; iDepth<=pTouchable->GetHistoryDepth(); iDepth++)
+	{
+		G4VPhysicalVolume *pVolume = pTouchable->GetVolume(iDepth);
+		for(size_t i=0; i<m_hKillVolumes.size(); i++)
+			if(pVolume == m_hKillVolumes[i])
+				return true;
+	}
+
+	return false;
+}
+
+//******************************************************************/
+// the limits of the region of the step, optical photons are tracked
+// one after the other, the boundaries are counted from the first step
+//******************************************************************/
+void muensterTPCSteppingAction::ApplyPhotonLimits(const G4Step *pStep)
+{
+	G4Track *pTrack = pStep->GetTrack();
+
+	if(pTrack->GetCurrentStepNumber() == 1)
+		m_iNbPhotonBoundaries = 0;
+	if(pStep->GetPostStepPoint()->GetStepStatus() == fGeomBoundary)
+		m_iNbPhotonBoundaries++;
+
+	G4StepPoint *pPreStepPoint = pStep->GetPreStepPoint();
+	G4int iRegion = REGION_GAPS;
+	if(pPreStepPoint->GetPosition().perp() < m_dTpcRadius)
+	{
+		if(pPreStepPoint->GetMaterial() == m_pLXeMaterial)
+			iRegion = REGION_LXE;
+		else if(pPreStepPoint->GetMaterial() == m_pGXeMaterial)
+			iRegion = REGION_GXE;
+	}
+
+	G4int iLimit = NB_LIMITS;
+	if(m_dPhotonMaxTrackLength[iRegion] > 0. && pTrack->GetTrackLength() > m_dPhotonMaxTrackLength[iRegion])
+		iLimit = LIMIT_TRACK_LENGTH;
+	else if(m_dPhotonMaxTime[iRegion] > 0. && pTrack->GetGlobalTime() > m_dPhotonMaxTime[iRegion])
+		iLimit = LIMIT_TIME;
+	else if(m_iPhotonMaxBoundaries[iRegion] > 0 && m_iNbPhotonBoundaries > m_iPhotonMaxBoundaries[iRegion])
+		iLimit = LIMIT_BOUNDARIES;
+
+	if(iLimit == NB_LIMITS)
+		return;
+
+	pTrack->SetTrackStatus(fStopAndKill);
+	m_lNbKilledPhotons[iRegion][iLimit]++;
+}
+
+void muensterTPCSteppingAction::PrintStatistics()
+{
+	if(IsEnabled())
+		G4cout << "Track killing: " << m_lNbKilledLeavingTracks << " tracks killed leaving the kill volumes, "
+			<< m_lNbKilledLowEnergyTracks << " tracks killed below " << m_dKillEnergy/keV << " keV outside the LXe, "
+			<< m_lNbAbortedEvents << " events aborted" << G4endl;
+
+	if(HasPhotonLimits())
+	{
+		G4cout << "Optical photon limits (killed by track length, time, boundaries):";
+		for(G4int i=0; i<NB_REGIONS; i++)
+			G4cout << " " << m_szRegionNames[i] << ": " << m_lNbKilledPhotons[i][LIMIT_TRACK_LENGTH] << ", "
+				<< m_lNbKilledPhotons[i][LIMIT_TIME] << ", " << m_lNbKilledPhotons[i][LIMIT_BOUNDARIES] << ((i+1 < NB_REGIONS)?(";"):(""));
+		G4cout << G4endl;
+	}
+}
+